@@ -0,0 +1,105 @@
+#include "CsrGraph.hpp"
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+static const char CSR_MAGIC[8] = {'G', 'R', 'A', 'P', 'H', 'C', 'S', 'R'};
+
+// Taille de l'en-tête : magie, 4 int32, nnz
+static const size_t CSR_HEADER = 8 + 4 * sizeof(int32_t) + sizeof(uint64_t);
+
+bool estGrapheCSR(const char* f) {
+    FILE* fp = fopen(f, "rb");
+    if (!fp) return false;
+    char magic[8];
+    bool ok = fread(magic, 1, sizeof(magic), fp) == sizeof(magic)
+              && memcmp(magic, CSR_MAGIC, sizeof(magic)) == 0;
+    fclose(fp);
+    return ok;
+}
+
+// Recopie les poids d'une ligne (entiers non signés de W octets) dans la matrice
+template <typename W>
+static void remplirLignes(int* mat, int n, const uint64_t* rowStart, const int32_t* col, const char* poids) {
+    const W* w = (const W*)poids;
+    for (int i = 0; i < n; ++i) {
+        int* ligne = mat + (size_t)i * n;
+        for (uint64_t k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+            ligne[col[k]] = (int)w[k];
+        }
+    }
+}
+
+int* lectureGrapheCSR(const char* f, int* nb_nodes) {
+    int fd = open(f, O_RDONLY);
+    if (fd < 0) {
+        cout << "Impossible d'ouvrir le fichier " << f << endl;
+        exit(1);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t)st.st_size < CSR_HEADER) {
+        cout << "Fichier CSR trop court : " << f << endl;
+        exit(1);
+    }
+    const size_t taille = (size_t)st.st_size;
+    void* base = mmap(nullptr, taille, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        cout << "Impossible de projeter le fichier " << f << " en memoire" << endl;
+        exit(1);
+    }
+    const char* p = (const char*)base;
+
+    int32_t params[4];
+    uint64_t nnz;
+    memcpy(params, p + 8, sizeof(params));
+    memcpy(&nnz, p + 8 + sizeof(params), sizeof(nnz));
+    const int n = params[0];
+    const int octetsPoids = params[1];
+
+    // Le fichier doit contenir exactement les trois tableaux annoncés
+    const size_t attendu = CSR_HEADER + (size_t)(n + 1) * sizeof(uint64_t)
+                         + (size_t)nnz * (sizeof(int32_t) + octetsPoids);
+    if (memcmp(p, CSR_MAGIC, sizeof(CSR_MAGIC)) != 0 || n < 0
+        || (octetsPoids != 1 && octetsPoids != 2 && octetsPoids != 4) || taille != attendu) {
+        cout << "Fichier CSR invalide : " << f << endl;
+        exit(1);
+    }
+
+    const uint64_t* rowStart = (const uint64_t*)(p + CSR_HEADER);
+    const int32_t* col = (const int32_t*)(rowStart + n + 1);
+    const char* poids = (const char*)(col + nnz);
+    if (rowStart[0] != 0 || rowStart[n] != nnz) {
+        cout << "Fichier CSR invalide : " << f << endl;
+        exit(1);
+    }
+    for (int i = 0; i < n; ++i) {
+        if (rowStart[i] > rowStart[i + 1]) {
+            cout << "Fichier CSR invalide : " << f << endl;
+            exit(1);
+        }
+    }
+    for (uint64_t k = 0; k < nnz; ++k) {
+        if (col[k] < 0 || col[k] >= n) {
+            cout << "Fichier CSR invalide (colonne " << col[k] << ") : " << f << endl;
+            exit(1);
+        }
+    }
+
+    (*nb_nodes) = n;
+    int* mat = new int[(size_t)n * n]();
+    if (octetsPoids == 1)      remplirLignes<uint8_t>(mat, n, rowStart, col, poids);
+    else if (octetsPoids == 2) remplirLignes<uint16_t>(mat, n, rowStart, col, poids);
+    else                       remplirLignes<uint32_t>(mat, n, rowStart, col, poids);
+
+    munmap(base, taille);
+    return mat;
+}
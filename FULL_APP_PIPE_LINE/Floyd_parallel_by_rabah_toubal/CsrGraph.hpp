@@ -0,0 +1,37 @@
+#ifndef CSRGRAPH_HPP
+#define CSRGRAPH_HPP
+
+/**
+ * @file CsrGraph.hpp
+ * @brief Lecture du graphe au format binaire CSR écrit par build_dot (--csr=F).
+ *
+ * Même avec la lecture native du .dot (ForGraphMPI.cpp), chaque ligne doit être
+ * analysée (noms des sommets, poids en texte) et les arêtes gardées en mémoire
+ * tant que le nombre de sommets n'est pas connu : environ 450 ms pour un .dot de
+ * 86 Mo. Le format CSR (décrit dans SEQUENCE_to_DOT/CsrGraph.hpp) donne le
+ * nombre de sommets dans l'en-tête : il est projeté en mémoire avec mmap et
+ * recopié directement dans la matrice d'adjacence, sans analyse de texte ni
+ * tampon d'arêtes.
+ *
+ * Les sommets sont numérotés comme dans le .dot écrit par build_dot (A1 -> 0,
+ * A2 -> 1, ...) : la matrice est la même que celle de lectureGrapheMPI.
+ */
+
+/**
+ * @brief Indique si le fichier commence par l'en-tête d'un graphe CSR.
+ */
+bool estGrapheCSR(const char* f);
+
+/**
+ * @brief Lit un graphe CSR et construit sa matrice d'adjacence dense.
+ *
+ * @param f        Chemin du fichier CSR.
+ * @param nb_nodes Rempli avec le nombre de sommets.
+ *
+ * @return Matrice nb_nodes × nb_nodes à plat (0 = pas d'arête), allouée avec
+ *         new[] et à libérer par l'appelant. Le programme s'arrête si le
+ *         fichier est illisible ou incohérent.
+ */
+int* lectureGrapheCSR(const char* f, int* nb_nodes);
+
+#endif // CSRGRAPH_HPP
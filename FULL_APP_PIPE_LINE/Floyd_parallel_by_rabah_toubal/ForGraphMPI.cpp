@@ -1,9 +1,332 @@
 #define OMPI_SKIP_MPICXX 1
 #include "ForGraphMPI.hpp"
+#include <charconv>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <string_view>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#ifdef FLOYD_CGRAPH
+#include <graphviz/cgraph.h>
+#endif
 
 using namespace std;
 
-int* lectureGrapheMPI(char* f, int* nb_nodes, map<string,int>* my_nodes) {
+namespace {
+
+// Arête lue dans le fichier : le nombre de sommets n'est connu qu'à la fin
+// de la lecture, donc les arêtes sont gardées ici (12 octets chacune) puis
+// recopiées dans la matrice n × n une fois n connu.
+struct AreteLue {
+    int i, j, poids;
+};
+
+/**
+ * Table de hachage à adressage ouvert : nom de sommet -> indice.
+ * Les noms sont des vues sur le fichier projeté en mémoire (pas de copie).
+ */
+class TableNoms {
+public:
+    TableNoms() : cases(1024, -1) {}
+
+    // Indice du sommet 'nom', créé s'il n'existe pas encore
+    int indice(string_view nom) {
+        if (2 * (noms.size() + 1) > cases.size()) agrandir();
+        size_t c = hacher(nom) & (cases.size() - 1);
+        while (cases[c] >= 0) {
+            if (noms[cases[c]] == nom) return cases[c];
+            c = (c + 1) & (cases.size() - 1);
+        }
+        cases[c] = (int)noms.size();
+        noms.push_back(nom);
+        return cases[c];
+    }
+
+    vector<string_view> noms;   // dans l'ordre d'apparition
+
+private:
+    vector<int> cases;          // -1 = case vide
+
+    static uint64_t hacher(string_view s) {
+        uint64_t h = 1469598103934665603ULL;   // FNV-1a
+        for (unsigned char c : s) h = (h ^ c) * 1099511628211ULL;
+        // Les bits de poids faible de FNV ne dépendent que de ceux des
+        // caractères : on y replie les bits de poids fort (A1, A2, ...)
+        return h ^ (h >> 32);
+    }
+
+    void agrandir() {
+        vector<int>(cases.size() * 2, -1).swap(cases);
+        for (size_t k = 0; k < noms.size(); ++k) {
+            size_t c = hacher(noms[k]) & (cases.size() - 1);
+            while (cases[c] >= 0) c = (c + 1) & (cases.size() - 1);
+            cases[c] = (int)k;
+        }
+    }
+};
+
+/**
+ * Lecture en une passe du texte, pour le sous-ensemble de DOT écrit par build_dot :
+ * déclarations de sommets (attributs quelconques, ignorés), arêtes "--"
+ * (éventuellement en chaîne) avec weight=, attributs par défaut
+ * node/edge/graph, commentaires. Tout le reste (digraph, sous-graphes,
+ * ports, HTML, concaténation "a" + "b") est signalé comme non pris en charge.
+ */
+class LecteurDot {
+public:
+    LecteurDot(const char* debut, size_t taille) : debut(debut), p(debut), fin(debut + taille) {}
+
+    bool lire(string* erreur);
+
+    TableNoms sommets;
+    vector<AreteLue> aretes;
+
+private:
+    const char* debut;
+    const char* p;
+    const char* fin;
+    deque<string> stock;        // identifiants entre guillemets contenant des échappements
+    string message;
+
+    bool echec(const string& quoi) {
+        int ligne = 1;
+        for (const char* q = debut; q < p; ++q) ligne += (*q == '\n');
+        message = "ligne " + to_string(ligne) + " : " + quoi;
+        return false;
+    }
+
+    void sauterBlancs();
+    bool lireId(string_view* id, bool* entreGuillemets);
+    bool lireAttributs(int* poids, bool* aPoids);
+
+    bool suivant(char c) { sauterBlancs(); return p < fin && *p == c; }
+    bool suiteArete() { sauterBlancs(); return fin - p >= 2 && p[0] == '-' && p[1] == '-'; }
+};
+
+// Classe de chaque octet : 1 = lettre (début d'identifiant), 2 = chiffre, 0 = autre
+struct ClassesOctets {
+    unsigned char classe[256];
+    constexpr ClassesOctets() : classe() {
+        for (int c = 0; c < 256; ++c) {
+            bool lettre = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c >= 0x80;
+            classe[c] = lettre ? 1 : (c >= '0' && c <= '9') ? 2 : 0;
+        }
+    }
+};
+static constexpr ClassesOctets CLASSES;
+
+static bool estLettre(unsigned char c) {
+    return CLASSES.classe[c] == 1;
+}
+
+static bool estChiffre(unsigned char c) {
+    return CLASSES.classe[c] == 2;
+}
+
+// Mot-clé DOT (insensible à la casse), pour un identifiant sans guillemets
+static bool motCle(string_view id, const char* mot) {
+    size_t n = strlen(mot);
+    if (id.size() != n) return false;
+    for (size_t k = 0; k < n; ++k) {
+        char c = id[k];
+        if (c >= 'A' && c <= 'Z') c = (char)(c - 'A' + 'a');
+        if (c != mot[k]) return false;
+    }
+    return true;
+}
+
+void LecteurDot::sauterBlancs() {
+    while (p < fin) {
+        unsigned char c = *p;
+        if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+            ++p;
+        } else if (c == '/' && fin - p >= 2 && p[1] == '/') {
+            while (p < fin && *p != '\n') ++p;
+        } else if (c == '/' && fin - p >= 2 && p[1] == '*') {
+            const char* f = p + 2;
+            while (f + 1 < fin && !(f[0] == '*' && f[1] == '/')) ++f;
+            p = (f + 1 < fin) ? f + 2 : fin;
+        } else if (c == '#' && (p == debut || p[-1] == '\n')) {
+            // Ligne de préprocesseur C, ignorée par Graphviz
+            while (p < fin && *p != '\n') ++p;
+        } else {
+            break;
+        }
+    }
+}
+
+bool LecteurDot::lireId(string_view* id, bool* entreGuillemets) {
+    sauterBlancs();
+    if (p >= fin) return echec("identifiant attendu, fin du fichier");
+    const char* d = p;
+    *entreGuillemets = false;
+    if (estLettre((unsigned char)*p)) {
+        const char* q = p + 1;
+        while (q < fin && CLASSES.classe[(unsigned char)*q] != 0) ++q;
+        p = q;
+    } else if (estChiffre((unsigned char)*p) || *p == '.'
+               || (*p == '-' && fin - p >= 2 && (estChiffre((unsigned char)p[1]) || p[1] == '.'))) {
+        ++p;
+        while (p < fin && (estChiffre((unsigned char)*p) || *p == '.')) ++p;
+    } else if (*p == '"') {
+        *entreGuillemets = true;
+        ++p;
+        bool echappe = false;
+        while (p < fin && *p != '"') {
+            if (*p == '\\' && fin - p >= 2) { echappe = true; ++p; }
+            ++p;
+        }
+        if (p >= fin) return echec("guillemet fermant manquant");
+        ++p;
+        if (echappe) {
+            // \" devient ", une barre oblique suivie d'un saut de ligne disparaît
+            string s;
+            for (const char* q = d + 1; q < p - 1; ++q) {
+                if (*q == '\\' && (q[1] == '"' || q[1] == '\n')) {
+                    ++q;
+                    if (*q == '\n') continue;
+                }
+                s += *q;
+            }
+            stock.push_back(std::move(s));
+            *id = stock.back();
+        } else {
+            *id = string_view(d + 1, (size_t)(p - d - 2));
+        }
+        if (suivant('+')) return echec("concatenation de chaines non prise en charge");
+        return true;
+    } else if (*p == '<') {
+        return echec("identifiant HTML non pris en charge");
+    } else {
+        return echec(string("caractere inattendu '") + *p + "'");
+    }
+    *id = string_view(d, (size_t)(p - d));
+    return true;
+}
+
+// Lit une ou plusieurs listes [a=b, ...] ; retient weight si poids != nullptr
+bool LecteurDot::lireAttributs(int* poids, bool* aPoids) {
+    while (suivant('[')) {
+        ++p;
+        while (true) {
+            sauterBlancs();
+            if (p >= fin) return echec("crochet fermant manquant");
+            if (*p == ']') { ++p; break; }
+            if (*p == ',' || *p == ';') { ++p; continue; }
+            string_view cle, valeur;
+            bool guillemets;
+            if (!lireId(&cle, &guillemets)) return false;
+            if (!suivant('=')) return echec("'=' attendu apres l'attribut " + string(cle));
+            ++p;
+            if (!lireId(&valeur, &guillemets)) return false;
+            if (poids && cle == "weight") {
+                // Comme std::stoi : partie entière, le reste est ignoré
+                const char* v = valeur.data();
+                const char* vf = v + valeur.size();
+                while (v < vf && (*v == ' ' || *v == '\t')) ++v;
+                if (v < vf && *v == '+') ++v;
+                auto r = from_chars(v, vf, *poids);
+                if (r.ec != errc()) return echec("poids invalide \"" + string(valeur) + "\"");
+                *aPoids = true;
+            }
+        }
+    }
+    return true;
+}
+
+bool LecteurDot::lire(string* erreur) {
+    string_view id;
+    bool guillemets;
+    bool ok = [&]() {
+        if (!lireId(&id, &guillemets)) return false;
+        if (!guillemets && motCle(id, "strict")) {
+            if (!lireId(&id, &guillemets)) return false;
+        }
+        if (!guillemets && motCle(id, "digraph")) return echec("graphe oriente (digraph) non pris en charge");
+        if (guillemets || !motCle(id, "graph")) return echec("'graph' attendu");
+        if (!suivant('{')) {
+            if (!lireId(&id, &guillemets)) return false;   // nom du graphe
+            if (!suivant('{')) return echec("'{' attendu");
+        }
+        ++p;
+
+        int poidsDefaut = 0;
+        bool aPoidsDefaut = false;
+        vector<int> chaine;
+        while (true) {
+            sauterBlancs();
+            if (p >= fin) return echec("accolade fermante manquante");
+            if (*p == '}') {
+                ++p;
+                sauterBlancs();
+                return p == fin || echec("texte apres la fin du graphe");
+            }
+            if (*p == ';' || *p == ',') { ++p; continue; }
+            if (*p == '{') return echec("sous-graphe non pris en charge");
+            const char* debutInstruction = p;
+            if (!lireId(&id, &guillemets)) return false;
+
+            if (!guillemets && (motCle(id, "node") || motCle(id, "graph"))) {
+                if (!lireAttributs(nullptr, nullptr)) return false;
+                continue;
+            }
+            if (!guillemets && motCle(id, "edge")) {
+                if (!lireAttributs(&poidsDefaut, &aPoidsDefaut)) return false;
+                continue;
+            }
+            if (!guillemets && motCle(id, "subgraph")) return echec("sous-graphe non pris en charge");
+
+            if (suivant('=')) {
+                // Attribut du graphe : a = b
+                ++p;
+                if (!lireId(&id, &guillemets)) return false;
+                continue;
+            }
+            if (suivant(':')) return echec("ports non pris en charge");
+            if (fin - p >= 2 && p[0] == '-' && p[1] == '>') return echec("arete orientee non prise en charge");
+
+            int u = sommets.indice(id);
+            if (!suiteArete()) {
+                // Déclaration de sommet : attributs ignorés (label, count, ...)
+                if (!lireAttributs(nullptr, nullptr)) return false;
+                continue;
+            }
+            chaine.assign(1, u);
+            while (suiteArete()) {
+                p += 2;
+                if (suivant('{')) return echec("sous-graphe non pris en charge");
+                if (!lireId(&id, &guillemets)) return false;
+                if (suivant(':')) return echec("ports non pris en charge");
+                chaine.push_back(sommets.indice(id));
+            }
+            int poids = poidsDefaut;
+            bool aPoids = aPoidsDefaut;
+            if (!lireAttributs(&poids, &aPoids)) return false;
+            if (!aPoids) {
+                p = debutInstruction;
+                return echec("arete sans poids (weight)");
+            }
+            for (size_t k = 0; k + 1 < chaine.size(); ++k) {
+                aretes.push_back({chaine[k], chaine[k + 1], poids});
+            }
+        }
+    }();
+    if (!ok) *erreur = message;
+    return ok;
+}
+
+} // namespace
+
+#ifdef FLOYD_CGRAPH
+// Lecture avec Graphviz (cgraph), pour les fichiers hors du sous-ensemble lu nativement
+static int* lectureGrapheCgraph(char* f, int* nb_nodes, map<string,int>* my_nodes) {
 
     FILE *fp = fopen(f, "r");
     if (!fp) {
@@ -11,24 +334,21 @@ int* lectureGrapheMPI(char* f, int* nb_nodes, map<string,int>* my_nodes) {
         exit(1);
     }
 
-
-
-
-    
     Agraph_t *g = agread(fp, NULL);
     fclose(fp);
 
     int nn = agnnodes(g);
     (*nb_nodes) = nn;
-    
+
+    my_nodes->clear();
     int t = 0;
     for (Agnode_t *n = agfstnode(g); n; n = agnxtnode(g, n)) {
         (*my_nodes)[agnameof(n)] = t;
         t++;
     }
 
-    int* mat = new int[nn * nn]();
-    
+    int* mat = new int[(size_t)nn * nn]();
+
     for (Agnode_t *n = agfstnode(g); n; n = agnxtnode(g, n)) {
         int i = (*my_nodes)[agnameof(n)];
         for (Agedge_t *e = agfstout(g, n); e; e = agnxtout(g, e)) {
@@ -42,3 +362,59 @@ int* lectureGrapheMPI(char* f, int* nb_nodes, map<string,int>* my_nodes) {
     agclose(g);
     return mat;
 }
+#endif
+
+int* lectureGrapheMPI(char* f, int* nb_nodes, map<string,int>* my_nodes) {
+
+    int fd = open(f, O_RDONLY);
+    if (fd < 0) {
+        cout << "Impossible d'ouvrir le fichier " << f << endl;
+        exit(1);
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0) {
+        cout << "Fichier vide ou illisible : " << f << endl;
+        exit(1);
+    }
+    const size_t taille = (size_t)st.st_size;
+    void* base = mmap(nullptr, taille, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) {
+        cout << "Impossible de projeter le fichier " << f << " en memoire" << endl;
+        exit(1);
+    }
+    madvise(base, taille, MADV_SEQUENTIAL);
+
+    LecteurDot lecteur((const char*)base, taille);
+    string erreur;
+    if (!lecteur.lire(&erreur)) {
+        munmap(base, taille);
+#ifdef FLOYD_CGRAPH
+        cout << "Lecture directe de " << f << " impossible (" << erreur
+             << "), lecture avec Graphviz" << endl;
+        return lectureGrapheCgraph(f, nb_nodes, my_nodes);
+#else
+        cout << "Fichier DOT non pris en charge : " << f << ", " << erreur
+             << " (recompiler avec CGRAPH=1 pour lire tout le format Graphviz)" << endl;
+        exit(1);
+#endif
+    }
+
+    int nn = (int)lecteur.sommets.noms.size();
+    (*nb_nodes) = nn;
+
+    my_nodes->clear();
+    for (int t = 0; t < nn; ++t) {
+        (*my_nodes)[string(lecteur.sommets.noms[t])] = t;
+    }
+
+    // Deuxième passe, sur les arêtes gardées (pas sur le texte) : remplissage de la matrice
+    int* mat = new int[(size_t)nn * nn]();
+    for (const AreteLue& a : lecteur.aretes) {
+        mat[(size_t)a.i * nn + a.j] = a.poids;
+        mat[(size_t)a.j * nn + a.i] = a.poids;
+    }
+
+    munmap(base, taille);
+    return mat;
+}
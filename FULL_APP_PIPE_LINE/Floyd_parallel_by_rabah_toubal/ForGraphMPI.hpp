@@ -4,7 +4,6 @@
 #include <iostream>
 #include <map>
 #include <string>
-#include <graphviz/cgraph.h>
 
 /**
  * @file ForGraphMPI.hpp
@@ -12,7 +11,8 @@
  *        construction de la matrice d'adjacence associée.
  *
  * Ce module fournit une fonction utilitaire permettant :
- *  - de lire un fichier de graphe au format .dot grâce à la bibliothèque Graphviz,
+ *  - de lire un fichier de graphe au format .dot (projeté en mémoire et analysé
+ *    en une seule passe, sans la bibliothèque Graphviz),
  *  - de numéroter les sommets de 0 à n-1,
  *  - de construire une matrice d'adjacence symétrique (graphe non orienté),
  *  - de remplir une table de correspondance entre les noms textuels des sommets
@@ -26,15 +26,23 @@
  * @brief Lit un graphe au format .dot et construit sa matrice d'adjacence.
  *
  * La fonction effectue les opérations suivantes :
- *  - ouverture du fichier .dot,
- *  - lecture du graphe avec la bibliothèque Graphviz (cgraph),
- *  - numérotation des sommets de 0 à n-1,
+ *  - projection du fichier .dot en mémoire (mmap),
+ *  - analyse en une passe : chaque nom de sommet est cherché dans une table de
+ *    hachage à adressage ouvert, chaque arête est gardée avec son poids (weight=),
+ *  - numérotation des sommets de 0 à n-1, dans l'ordre d'apparition (comme Graphviz),
  *  - construction d'une matrice d'adjacence dense de taille n × n,
  *    initialisée à 0 et remplie avec les poids des arêtes.
  *
  * Le graphe est supposé non orienté : pour chaque arête (u, v) de poids w,
  * la matrice est mise à jour en position (i, j) et (j, i).
  *
+ * Seul le sous-ensemble de DOT écrit par build_dot est lu directement :
+ * `graph`, déclarations de sommets (attributs ignorés, comme label ou count),
+ * arêtes `--` avec weight=, attributs par défaut `node`/`edge`/`graph`,
+ * commentaires. Pour un autre fichier (sous-graphes, digraph, ports...), le
+ * programme s'arrête avec le numéro de ligne fautif, sauf s'il est compilé
+ * avec FLOYD_CGRAPH (make CGRAPH=1) : la lecture passe alors par Graphviz.
+ *
  * @param f        Chemin du fichier .dot à lire.
  * @param nb_nodes Pointeur vers un entier dans lequel sera stocké
  *                 le nombre total de sommets du graphe.
@@ -0,0 +1,319 @@
+#include "MinPlusKernels.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+#include <unistd.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#define MINPLUS_X86 1
+#endif
+
+// Même valeur que INF dans ParallelFWBlocks.cpp : "pas de chemin"
+static const int INF_SENTINEL = 1000000000;
+
+// d[j] = min(d[j], a + s[j]) pour j < w, sans aucun test sur INF
+// (voir MinPlusKernels.hpp). La boucle est vectorisée par le compilateur
+// avec le jeu d'instructions de la fonction dans laquelle elle est incluse :
+// c'est pour ça que tout est always_inline jusqu'aux fonctions target() du bas.
+__attribute__((always_inline))
+static inline void minPlusRow(int* d, const int* s, int a, int w) {
+    for (int j = 0; j < w; ++j) {
+        int via = a + s[j];
+        d[j] = (via < d[j]) ? via : d[j];
+    }
+}
+
+// Phase A : Floyd-Warshall classique à l'intérieur du bloc pivot.
+// kk est le pivot local, et pour chaque ligne i j'essaie de passer par kk :
+// la ligne i reçoit min(Dkk[i][j], Dkk[i][kk] + Dkk[kk][j]).
+// Quand i == kk, la ligne se met à jour avec elle-même, mais Dkk[kk][kk] >= 0
+// donc elle ne change pas (pareil pour Dkk[i][kk] quand j == kk).
+__attribute__((always_inline))
+static inline void fwBlockImpl(int* Dkk, int bs, int b) {
+    for (int kk = 0; kk < bs; ++kk) {
+        const int* rowK = Dkk + kk * b;
+        for (int i = 0; i < bs; ++i) {
+            minPlusRow(Dkk + i * b, rowK, Dkk[i * b + kk], bs);
+        }
+    }
+}
+
+// Phase B, ligne du pivot : le bloc DkJ s'améliore avec les chemins
+// i -> kk (dans le pivot Dkk) puis kk -> j (dans DkJ lui-même).
+__attribute__((always_inline))
+static inline void fwRowImpl(const int* Dkk, int* DkJ, int bs, int wJ, int b) {
+    for (int i = 0; i < bs; ++i) {
+        for (int kk = 0; kk < bs; ++kk) {
+            minPlusRow(DkJ + i * b, DkJ + kk * b, Dkk[i * b + kk], wJ);
+        }
+    }
+}
+
+// Phase B, colonne du pivot : le bloc Dik s'améliore avec les chemins
+// i -> kk (dans Dik lui-même) puis kk -> j (dans le pivot Dkk).
+__attribute__((always_inline))
+static inline void fwColImpl(int* Dik, const int* Dkk, int hI, int bs, int b) {
+    for (int i = 0; i < hI; ++i) {
+        for (int kk = 0; kk < bs; ++kk) {
+            minPlusRow(Dik + i * b, Dkk + kk * b, Dik[i * b + kk], bs);
+        }
+    }
+}
+
+// ===== Phase C : produit (min, +) par tuiles, comme un GEMM =====
+//
+// Dij = min(Dij, Dik ⊗ DkJ) : i -> kk dans Dik (colonne du pivot), puis
+// kk -> j dans DkJ (ligne du pivot). C'est là que se fait presque tout le
+// calcul en O(n^3). Dik et DkJ ne changent pas pendant la mise à jour, donc
+// l'ordre des kk n'a pas d'importance : on peut faire la boucle sur kk en
+// dernier et garder une tuile MR × NR de Dij dans les registres.
+//
+// Découpage (comme BLIS) :
+//   jc : NC colonnes de DkJ, empaquetées une fois     (kc × nc, cache L3)
+//   pc : KC valeurs de kk à la fois
+//   ic : MC lignes de Dik, empaquetées une fois       (mc × kc, cache L2)
+//   jr, ir : une tuile MR × NR de Dij                 (bande kc × nr de DkJ en L1)
+//
+// Les bandes empaquetées sont complétées avec INF : INF + INF = 2 × 10^9
+// tient encore dans un int, et ces cases ne sont jamais recopiées dans Dij.
+
+// Micro-noyau : tuile MR × (NV × W) de C (pas ldc), kc valeurs de kk.
+// Ap : kc × MR (Dik, une colonne kk après l'autre), Bp : kc × NR (DkJ).
+// Les accumulateurs sont des vecteurs de W entiers (extension vector_size de
+// GCC) : une fois la fonction incluse dans une fonction target(), ils sont
+// compilés en registres SSE2, AVX2 ou AVX-512.
+template <int W, int MR, int NV>
+__attribute__((always_inline))
+static inline void minPlusMicroKernel(int kc, const int* Ap, const int* Bp, int* C, int ldc) {
+    typedef int V __attribute__((vector_size(W * sizeof(int))));
+    const int NR = W * NV;
+    V acc[MR][NV];
+    for (int r = 0; r < MR; ++r)
+        for (int v = 0; v < NV; ++v)
+            memcpy(&acc[r][v], C + r * ldc + v * W, sizeof(V));
+
+    for (int k = 0; k < kc; ++k) {
+        V bk[NV];
+        for (int v = 0; v < NV; ++v) memcpy(&bk[v], Bp + k * NR + v * W, sizeof(V));
+        for (int r = 0; r < MR; ++r) {
+            V a = Ap[k * MR + r] + V{};     // diffusion de Dik[i][kk]
+            for (int v = 0; v < NV; ++v) {
+                V via = a + bk[v];
+                acc[r][v] = (via < acc[r][v]) ? via : acc[r][v];
+            }
+        }
+    }
+
+    for (int r = 0; r < MR; ++r)
+        for (int v = 0; v < NV; ++v)
+            memcpy(C + r * ldc + v * W, &acc[r][v], sizeof(V));
+}
+
+template <class Tile>
+__attribute__((always_inline))
+static inline void fwInnerImpl(const int* Dik, const int* DkJ, int* Dij,
+                               int hI, int wJ, int bs, int b, const MinPlusBlocking& blk) {
+    const int W = Tile::W, MR = Tile::MR, NV = Tile::NV;
+    const int NR = W * NV;
+    const int KC = blk.kc;
+    const int MC = blk.mc;
+    const int NC = blk.nc;
+
+    // Bandes empaquetées, gardées d'un appel à l'autre (une par thread)
+    thread_local std::vector<int> Ap, Bp;
+    Ap.resize((size_t)(MC + MR) * KC);
+    Bp.resize((size_t)(NC + NR) * KC);
+
+    for (int jc = 0; jc < wJ; jc += NC) {
+        int nc = std::min(NC, wJ - jc);
+        for (int pc = 0; pc < bs; pc += KC) {
+            int kc = std::min(KC, bs - pc);
+
+            // DkJ[pc.., jc..] -> bandes de NR colonnes : Bp[jr * kc + k * NR + j]
+            for (int jr = 0; jr < nc; jr += NR) {
+                int* dst = Bp.data() + (size_t)jr * kc;
+                int w = std::min(NR, nc - jr);
+                for (int k = 0; k < kc; ++k) {
+                    const int* src = DkJ + (size_t)(pc + k) * b + jc + jr;
+                    for (int j = 0; j < w; ++j) dst[k * NR + j] = src[j];
+                    for (int j = w; j < NR; ++j) dst[k * NR + j] = INF_SENTINEL;
+                }
+            }
+
+            for (int ic = 0; ic < hI; ic += MC) {
+                int mc = std::min(MC, hI - ic);
+
+                // Dik[ic.., pc..] -> bandes de MR lignes : Ap[ir * kc + k * MR + r]
+                for (int ir = 0; ir < mc; ir += MR) {
+                    int* dst = Ap.data() + (size_t)ir * kc;
+                    int h = std::min(MR, mc - ir);
+                    for (int k = 0; k < kc; ++k) {
+                        for (int r = 0; r < h; ++r) dst[k * MR + r] = Dik[(size_t)(ic + ir + r) * b + pc + k];
+                        for (int r = h; r < MR; ++r) dst[k * MR + r] = INF_SENTINEL;
+                    }
+                }
+
+                for (int jr = 0; jr < nc; jr += NR) {
+                    int w = std::min(NR, nc - jr);
+                    for (int ir = 0; ir < mc; ir += MR) {
+                        int h = std::min(MR, mc - ir);
+                        const int* a = Ap.data() + (size_t)ir * kc;
+                        const int* bb = Bp.data() + (size_t)jr * kc;
+                        int* c = Dij + (size_t)(ic + ir) * b + jc + jr;
+                        if (h == MR && w == NR) {
+                            minPlusMicroKernel<W, MR, NV>(kc, a, bb, c, b);
+                        } else {
+                            // Tuile du bord : on passe par une tuile complète en local,
+                            // dont les cases hors du bloc valent INF (jamais recopiées)
+                            int tmp[MR * NR];
+                            std::fill(tmp, tmp + MR * NR, INF_SENTINEL);
+                            for (int r = 0; r < h; ++r)
+                                for (int j = 0; j < w; ++j) tmp[r * NR + j] = c[(size_t)r * b + j];
+                            minPlusMicroKernel<W, MR, NV>(kc, a, bb, tmp, NR);
+                            for (int r = 0; r < h; ++r)
+                                for (int j = 0; j < w; ++j) c[(size_t)r * b + j] = tmp[r * NR + j];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+// Tuiles de Dij gardées dans les registres : MR lignes × NV vecteurs de W entiers.
+// Il faut MR × NV accumulateurs, plus NV vecteurs de DkJ et une diffusion :
+//   SSE2    (16 registres) : 4 × 8   -> 8 + 2 + 1
+//   AVX2    (16 registres) : 6 × 16  -> 12 + 2 + 1
+//   AVX-512 (32 registres) : 12 × 32 -> 24 + 2 + 1
+struct TileGeneric { static const int W = 4,  MR = 4,  NV = 2; };
+struct TileAVX2    { static const int W = 8,  MR = 6,  NV = 2; };
+struct TileAVX512  { static const int W = 16, MR = 12, NV = 2; };
+
+// Version générique : jeu d'instructions de la compilation (SSE2 sur x86-64)
+static void fwBlockGeneric(int* Dkk, int bs, int b) {
+    fwBlockImpl(Dkk, bs, b);
+}
+static void fwRowGeneric(const int* Dkk, int* DkJ, int bs, int wJ, int b) {
+    fwRowImpl(Dkk, DkJ, bs, wJ, b);
+}
+static void fwColGeneric(int* Dik, const int* Dkk, int hI, int bs, int b) {
+    fwColImpl(Dik, Dkk, hI, bs, b);
+}
+static void fwInnerGeneric(const int* Dik, const int* DkJ, int* Dij, int hI, int wJ, int bs, int b,
+                           const MinPlusBlocking& blk) {
+    fwInnerImpl<TileGeneric>(Dik, DkJ, Dij, hI, wJ, bs, b, blk);
+}
+
+#ifdef MINPLUS_X86
+
+// Chaque version est compilée pour son jeu d'instructions avec l'attribut
+// target : pas besoin de -mavx2 pour tout le programme, et le code ne sera
+// exécuté que si selectMinPlusKernel a vérifié que le processeur le supporte.
+
+// AVX2 : vpaddd / vpminsd sur 8 entiers
+__attribute__((target("avx2")))
+static void fwBlockAVX2(int* Dkk, int bs, int b) {
+    fwBlockImpl(Dkk, bs, b);
+}
+__attribute__((target("avx2")))
+static void fwRowAVX2(const int* Dkk, int* DkJ, int bs, int wJ, int b) {
+    fwRowImpl(Dkk, DkJ, bs, wJ, b);
+}
+__attribute__((target("avx2")))
+static void fwColAVX2(int* Dik, const int* Dkk, int hI, int bs, int b) {
+    fwColImpl(Dik, Dkk, hI, bs, b);
+}
+__attribute__((target("avx2")))
+static void fwInnerAVX2(const int* Dik, const int* DkJ, int* Dij, int hI, int wJ, int bs, int b,
+                        const MinPlusBlocking& blk) {
+    fwInnerImpl<TileAVX2>(Dik, DkJ, Dij, hI, wJ, bs, b, blk);
+}
+
+// AVX-512 : 16 entiers par instruction. Sans prefer-vector-width=512,
+// GCC s'en tiendrait à des registres de 256 bits.
+__attribute__((target("avx512f,prefer-vector-width=512")))
+static void fwBlockAVX512(int* Dkk, int bs, int b) {
+    fwBlockImpl(Dkk, bs, b);
+}
+__attribute__((target("avx512f,prefer-vector-width=512")))
+static void fwRowAVX512(const int* Dkk, int* DkJ, int bs, int wJ, int b) {
+    fwRowImpl(Dkk, DkJ, bs, wJ, b);
+}
+__attribute__((target("avx512f,prefer-vector-width=512")))
+static void fwColAVX512(int* Dik, const int* Dkk, int hI, int bs, int b) {
+    fwColImpl(Dik, Dkk, hI, bs, b);
+}
+__attribute__((target("avx512f,prefer-vector-width=512")))
+static void fwInnerAVX512(const int* Dik, const int* DkJ, int* Dij, int hI, int wJ, int bs, int b,
+                          const MinPlusBlocking& blk) {
+    fwInnerImpl<TileAVX512>(Dik, DkJ, Dij, hI, wJ, bs, b, blk);
+}
+
+#endif // MINPLUS_X86
+
+bool cpuSupportsMinPlus(MinPlusLevel level) {
+#ifdef MINPLUS_X86
+    __builtin_cpu_init();
+    switch (level) {
+        case MinPlusLevel::AVX2:
+            return __builtin_cpu_supports("avx2");
+        case MinPlusLevel::AVX512:
+            return __builtin_cpu_supports("avx512f");
+        default:
+            return true;
+    }
+#else
+    return level == MinPlusLevel::Generic || level == MinPlusLevel::Auto;
+#endif
+}
+
+// Découpage d'après les caches : chaque bande occupe au plus la moitié
+// de son niveau de cache, le reste servant aux autres bandes et à Dij.
+template <class Tile>
+static MinPlusBlocking blockingFor() {
+    const int mr = Tile::MR;
+    const int nr = Tile::W * Tile::NV;
+    long l1 = -1, l2 = -1, l3 = -1;
+#ifdef _SC_LEVEL1_DCACHE_SIZE
+    l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+    l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+    l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+#endif
+    // Valeurs prudentes si le système ne sait pas
+    if (l1 <= 0) l1 = 32 * 1024;
+    if (l2 <= 0) l2 = 256 * 1024;
+    if (l3 <= 0) l3 = 4 * 1024 * 1024;
+
+    MinPlusBlocking blk;
+    blk.mr = mr;
+    blk.nr = nr;
+    blk.kc = std::max(16L, l1 / 2 / (nr * (long)sizeof(int)));
+    blk.mc = std::max((long)mr, l2 / 2 / (blk.kc * (long)sizeof(int)) / mr * mr);
+    blk.nc = std::max((long)nr, l3 / 2 / (blk.kc * (long)sizeof(int)) / nr * nr);
+    return blk;
+}
+
+static MinPlusKernel kernelFor(MinPlusLevel level) {
+    switch (level) {
+#ifdef MINPLUS_X86
+        case MinPlusLevel::AVX2:
+            return {fwBlockAVX2, fwRowAVX2, fwColAVX2, fwInnerAVX2, "avx2", blockingFor<TileAVX2>()};
+        case MinPlusLevel::AVX512:
+            return {fwBlockAVX512, fwRowAVX512, fwColAVX512, fwInnerAVX512, "avx512", blockingFor<TileAVX512>()};
+#endif
+        default:
+            return {fwBlockGeneric, fwRowGeneric, fwColGeneric, fwInnerGeneric, "generic", blockingFor<TileGeneric>()};
+    }
+}
+
+MinPlusKernel selectMinPlusKernel(MinPlusLevel wanted) {
+    if (wanted == MinPlusLevel::Auto) {
+        // Du plus large au plus simple : on garde le premier supporté
+        const MinPlusLevel order[] = {MinPlusLevel::AVX512, MinPlusLevel::AVX2};
+        for (MinPlusLevel level : order) {
+            if (cpuSupportsMinPlus(level)) return kernelFor(level);
+        }
+        return kernelFor(MinPlusLevel::Generic);
+    }
+    return kernelFor(wanted);
+}
@@ -0,0 +1,97 @@
+#ifndef MIN_PLUS_KERNELS_HPP
+#define MIN_PLUS_KERNELS_HPP
+
+/**
+ * @file MinPlusKernels.hpp
+ * @brief Mises à jour min-plus des blocs de Floyd–Warshall (phases A, B et C),
+ *        sans branchement et vectorisées (SSE2, AVX2, AVX-512).
+ *
+ * Chaque mise à jour se ramène à la même opération sur une ligne de bloc :
+ * @code
+ *   d[j] = min(d[j], a + s[j])      pour j < w
+ * @endcode
+ * Les anciennes boucles sautaient les cases INF avec un `if (... == INF) continue;`
+ * dans la boucle la plus interne, ce qui empêchait le compilateur de la vectoriser.
+ * Ici il n'y a plus de test : INF = 10^9 sert de sentinelle, et comme toutes
+ * les cases restent <= INF, a + s[j] <= 2 × 10^9 ne déborde pas d'un int. Un
+ * chemin qui passe par une case INF donne a + s[j] >= INF >= d[j], donc ne
+ * change rien : le résultat est exactement celui des boucles avec tests
+ * (poids positifs ou nuls, comme les distances de build_dot).
+ *
+ * La boucle est alors compilée avec vpaddd / vpminsd (8 cases par instruction
+ * en AVX2, 16 en AVX-512). Comme pour les noyaux de Hamming de build_dot, le
+ * jeu d'instructions est choisi à l'exécution (CPUID) : le même exécutable
+ * prend le meilleur noyau sur chaque nœud.
+ *
+ * La phase C (blocs internes, presque tout le calcul) est un produit de
+ * matrices (min, +) : Dij = min(Dij, Dik ⊗ DkJ), sans dépendance entre les kk
+ * puisque Dik et DkJ ne changent pas. Elle est organisée comme un GEMM :
+ * Dik et DkJ sont recopiés (empaquetés) en bandes contiguës, et une tuile
+ * mr × nr de Dij reste dans les registres pendant toute la boucle sur kk,
+ * au lieu d'être relue et réécrite en mémoire à chaque kk. Les tailles des
+ * bandes (kc, mc, nc) sont choisies pour tenir dans les caches L1, L2 et L3.
+ */
+
+/**
+ * @brief Jeu d'instructions demandé pour les noyaux min-plus.
+ */
+enum class MinPlusLevel {
+    Auto,     /**< Le meilleur noyau supporté par le processeur. */
+    Generic,  /**< Jeu d'instructions de la compilation (SSE2 sur x86-64). */
+    AVX2,     /**< 8 cases par instruction. */
+    AVX512    /**< 16 cases par instruction (AVX-512F). */
+};
+
+/**
+ * @struct MinPlusBlocking
+ * @brief Découpage de la phase C pour les caches (voir MinPlusKernels.cpp).
+ */
+struct MinPlusBlocking {
+    int mr;   /**< Lignes de la tuile de Dij gardée dans les registres (fixé par le noyau). */
+    int nr;   /**< Colonnes de cette tuile (fixé par le noyau). */
+    int kc;   /**< Profondeur d'un passage : une bande kc × nr de DkJ tient dans la moitié de L1. */
+    int mc;   /**< Lignes de Dik empaquetées ensemble : mc × kc tient dans la moitié de L2. */
+    int nc;   /**< Colonnes de DkJ empaquetées ensemble : kc × nc tient dans la moitié de L3. */
+};
+
+/**
+ * @struct MinPlusKernel
+ * @brief Les quatre mises à jour de blocs d'un même jeu d'instructions.
+ *
+ * Les blocs sont stockés à plat avec un pas de b entiers par ligne ; bs est
+ * la taille réelle du pivot, hI et wJ la hauteur et la largeur réelles du
+ * bloc mis à jour (plus petites que b sur les bords de la matrice).
+ */
+struct MinPlusKernel {
+    /** Phase A : Floyd–Warshall complet dans le bloc pivot Dkk. */
+    void (*block)(int* Dkk, int bs, int b);
+    /** Phase B : bloc DkJ de la ligne du pivot, via Dkk. */
+    void (*row)(const int* Dkk, int* DkJ, int bs, int wJ, int b);
+    /** Phase B : bloc Dik de la colonne du pivot, via Dkk. */
+    void (*col)(int* Dik, const int* Dkk, int hI, int bs, int b);
+    /** Phase C : bloc interne Dij, via Dik et DkJ (Dij ne doit recouvrir ni Dik ni DkJ). */
+    void (*inner)(const int* Dik, const int* DkJ, int* Dij, int hI, int wJ, int bs, int b,
+                  const MinPlusBlocking& blocking);
+    const char* name;           /**< Nom lisible ("generic", "avx2", "avx512"). */
+    MinPlusBlocking blocking;   /**< Découpage à passer à inner. */
+};
+
+/**
+ * @brief Vrai si le processeur courant supporte le jeu d'instructions level
+ *        (toujours vrai pour Generic et Auto).
+ */
+bool cpuSupportsMinPlus(MinPlusLevel level);
+
+/**
+ * @brief Choisit les noyaux min-plus à utiliser sur ce processus.
+ *
+ * @param wanted Jeu d'instructions demandé. Avec MinPlusLevel::Auto, on prend
+ *               le plus large supporté par le processeur. Un jeu demandé mais
+ *               non supporté doit être écarté avant (cpuSupportsMinPlus).
+ *
+ * Le découpage (blocking) est calculé d'après les tailles de cache du
+ * processeur (sysconf) ; kc, mc et nc peuvent ensuite être modifiés.
+ */
+MinPlusKernel selectMinPlusKernel(MinPlusLevel wanted);
+
+#endif // MIN_PLUS_KERNELS_HPP
@@ -7,178 +7,41 @@
 #include <iostream>
 #include "ParallelFWBlocks.hpp"
 #include "Distribution.hpp"
+#include "MinPlusKernels.hpp"
+#include "ThreadPool.hpp"
 
 using namespace std;
 
 static const int INF = 1000000000;
 
-// ===== HELPERS  =====
-
-// Cette fonction c'est moi qui l'utilise pour faire le Floyd-Warshall
-// mais seulement a l'intérieur d'un seul bloc (un carre b x b).
-// bs c'est la "vraie" taille du bloc, parce que des fois a la fin
-// le bloc déborde de la matrice et du coup il est pas complet.
-
-// En gros ici je fais les 3 boucles classiques de Floyd-Warshall :
-// kk c'est le pivot dans le bloc,
-// i c'est la ligne,
-// j c'est la colonne.
-
-// Pour chaque i et j, je regarde si passer par kk (donc faire i -> kk -> j)
-// donne un chemin plus court que ce que j'avais deja.
-
-// Je fais bien gaffe aux INF : si la distance i->kk ou kk->j vaut INF,
-// ça veut dire que ce chemin existe pas, donc je continue et j’évite
-// de faire des additions qui servent a rien.
-
-// Au final, si "via" est plus petit que la distance actuelle i->j,
-// alors je mets à jour la case dans Dkk.
-static void fw_block(int* Dkk, int bs, int b) {
-    for (int kk = 0; kk < bs; ++kk) {
-        for (int i = 0; i < bs; ++i) {
-            int dik = Dkk[i * b + kk];
-            if (dik == INF) continue;
-            for (int j = 0; j < bs; ++j) {
-                int kkj = Dkk[kk * b + j];
-                if (kkj == INF) continue;
-                int via = dik + kkj;
-                int& dij = Dkk[i * b + j];
-                if (via < dij) dij = via;
-            }
-        }
-    }
-}
-
-// Ici je fais la mise à jour des blocs qui sont sur la même ligne
-// que le bloc pivot Dkk. Donc en gros : [ D(k,k) ] -> propage vers [ D(k,J) ].
-//
-// Cette fonction fw_row prend le bloc pivot Dkk et un bloc DkJ
-// qui est dans la même "row" (ligne) que le pivot.
-//
-// bs c'est la taille réelle du bloc pivot (peut être plus petit en bas à droite),
-// et wJ c'est la largeur réelle du bloc DkJ (pareil, pour éviter de dépasser la vraie matrice).
-//
-// Dans cette boucle, je fais exactement le même principe que FW classique,
-// sauf que cette fois j'utilise les distances du pivot Dkk et j'essaie
-// d'améliorer les distances DkJ (donc entre les sommets de la ligne k et la colonne J).
-//
-// Pour chaque i dans le bloc pivot,
-// je teste tous les kk comme pivot local,
-// puis tous les j de la bande DkJ.
-//
-// Si le chemin i -> kk est INF ou kk -> j est INF,
-// je skip parce que ça sert à rien de continuer.
-// Sinon je calcule le chemin "via" = i -> kk -> j,
-// et si il est plus petit que ce que j'avais dans DkJ,
-// je mets à jour.
-//
-// En gros, cette fonction sert juste à propager la ligne du pivot
-// vers les blocs de droite dans la grille de blocs.
-static void fw_row(const int* Dkk, int* DkJ, int bs, int wJ, int b) {
-    for (int i = 0; i < bs; ++i) {
-        for (int kk = 0; kk < bs; ++kk) {
-            int dik = Dkk[i * b + kk];
-            if (dik == INF) continue;
-            for (int j = 0; j < wJ; ++j) {
-                int kkj = DkJ[kk * b + j];
-                if (kkj == INF) continue;
-                int via = dik + kkj;
-                int& dij = DkJ[i * b + j];
-                if (via < dij) dij = via;
-            }
-        }
-    }
-}
-
-
-// Cette fonction fw_col c'est un peu la même idée que fw_row,
-// sauf que là je travaille sur la COLONNE du pivot au lieu de la ligne.
-//
-// Le bloc Dkk c'est toujours le bloc pivot (au centre),
-// mais cette fois je propage ses infos vers un bloc qui est juste
-// en dessous du pivot, qu'on appelle Dik.
-//
-// hI c'est la hauteur réelle du bloc Dik (ça évite de dépasser la matrice
-// quand on tombe sur les blocs du bas), et bs c'est la taille réelle du pivot.
-//
-// Le principe est simple : pour chaque cellule (i,j) du bloc Dik,
-// j'essaie de l'améliorer en passant par le pivot : i -> kk -> j.
-//
-// i = ligne du bloc Dik,
-// kk = pivot local dans le bloc Dkk,
-// j = colonne dans le bloc Dik.
-//
-// Comme d'habitude, si ik ou kj vaut INF,
-// je continue parce que ça veut dire que ce chemin n'existe pas,
-// donc aucun intérêt de calculer.
-//
-// Sinon je calcule "via" = ik + kj.
-// Si "via" est plus petit que Dik[i][j],
-// je mets à jour.
-//
-// Au final fw_col met à jour tous les blocs situés SOUS le bloc pivot,
-// en utilisant les infos du pivot pour améliorer leurs distances.
-static void fw_col(int* Dik, const int* Dkk, int hI, int bs, int b) {
-    for (int i = 0; i < hI; ++i) {
-        for (int kk = 0; kk < bs; ++kk) {
-            int ik = Dik[i * b + kk];
-            if (ik == INF) continue;
-            for (int j = 0; j < bs; ++j) {
-                int kj = Dkk[kk * b + j];
-                if (kj == INF) continue;
-                int via = ik + kj;
-                int& ij = Dik[i * b + j];
-                if (via < ij) ij = via;
-            }
-        }
-    }
-}
-
-
-// fw_inner c'est la partie où je mets à jour les blocs "au milieu",
-// c’est-à-dire ceux qui ne sont ni dans la même ligne que le pivot,
-// ni dans la même colonne, mais qui sont dans le rectangle autour.
-//
-// En fait pour un bloc Dij, je peux l’améliorer en combinant :
-//    Dik  (bloc dans la colonne du pivot)
-//    DkJ  (bloc dans la ligne du pivot)
-//
-// Donc je fais le chemin i -> kk via le bloc Dik,
-// puis kk -> j via DkJ.
-//
-// hI c’est la hauteur réelle du bloc (si on est en bas de la matrice),
-// wJ c’est la largeur réelle du bloc (si on est à droite),
-// et bs c’est la taille du pivot local.
-//
-// Comme d’hab, si ik est INF ou kj est INF,
-// je continue direct, parce que ça veut dire que ce chemin n’existe même pas.
-//
-// Je calcule "via" = ik + kj,
-// et si ça améliore la distance qu’il y avait déjà dans Dij,
-// je mets à jour.
-//
-// En vrai fw_inner c’est la partie qui propage le pivot dans tous les blocs
-// qui ne sont pas directement collés au pivot, un peu comme une mise à jour
-// du carré central dans Floyd-Warshall mais en version découpée en blocs.
-static void fw_inner(const int* Dik, const int* DkJ, int* Dij, 
-                     int hI, int wJ, int bs, int b) {
-    for (int i = 0; i < hI; ++i) {
-        for (int kk = 0; kk < bs; ++kk) {
-            int ik = Dik[i * b + kk];
-            if (ik == INF) continue;
-            for (int j = 0; j < wJ; ++j) {
-                int kj = DkJ[kk * b + j];
-                if (kj == INF) continue;
-                int via = ik + kj;
-                int& ij = Dij[i * b + j];
-                if (via < ij) ij = via;
-            }
-        }
+// Les mises à jour des blocs (fw_block, fw_row, fw_col, fw_inner) sont dans
+// MinPlusKernels.cpp, en version vectorisée choisie à l'exécution.
+
+// Une tâche pour les threads d'un rang : la bande [off, off + len) d'un bloc
+// local (des lignes ou des colonnes selon la phase).
+struct StripTask {
+    int idx;   // bloc local
+    int off;
+    int len;
+};
+
+// Découpe les blocs de items (extent cases utiles dans la dimension coupée)
+// en bandes de taille multiple de align, pour avoir au moins 2 tâches par
+// thread. Avec un seul thread, un bloc = une tâche, comme avant.
+static void addStrips(vector<StripTask>& tasks, int idx, int extent, int nItems,
+                      int nThreads, int b, int align) {
+    int parts = 1;
+    if (nThreads > 1 && nItems > 0) parts = (2 * nThreads + nItems - 1) / nItems;
+    int strip = (b + parts - 1) / parts;
+    strip = std::max(align, (strip + align - 1) / align * align);
+    for (int off = 0; off < extent; off += strip) {
+        tasks.push_back({idx, off, std::min(strip, extent - off)});
     }
 }
 
 // ===== =====
-int* ParallelFloydWarshallBlocks(int n, int* mat) {
+int* ParallelFloydWarshallBlocks(int n, int* mat, const MinPlusKernel& kernel, int nThreads,
+                                 bool lookahead) {
     using namespace std;
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -217,6 +80,12 @@ int* ParallelFloydWarshallBlocks(int n, int* mat) {
         cout << "[INFO] Taille bloc    : " << b << "x" << b << endl;
         cout << "[INFO] Nombre blocs   : " << nb << "x" << nb << endl;
         cout << "[INFO] Processus      : " << size << endl;
+        cout << "[INFO] Noyau min-plus : " << kernel.name
+             << " (tuiles " << kernel.blocking.mr << "x" << kernel.blocking.nr
+             << ", kc=" << kernel.blocking.kc << ", mc=" << kernel.blocking.mc
+             << ", nc=" << kernel.blocking.nc << ")" << endl;
+        cout << "[INFO] Threads/rang   : " << nThreads << endl;
+        cout << "[INFO] Lookahead      : " << (lookahead ? "oui" : "non") << endl;
         if (!grilleCarree) {
             cout << "[WARN] p non carré parfait ou n non multiple de sqrt(p) : b adaptatif utilise." << endl;
         }
@@ -238,6 +107,27 @@ int* ParallelFloydWarshallBlocks(int n, int* mat) {
     int Pr = dims[0];
     int Pc = dims[1];
 
+    // Grille cartésienne sur ces dimensions, sans renuméroter les rangs
+    // (reorder = 0) : le processus (pr, pc) garde le rang pr * Pc + pc
+    // utilisé par ownerOf. J'en tire deux sous-communicateurs :
+    //  - rowComm : les Pc processus de ma ligne de grille (rang = pc),
+    //  - colComm : les Pr processus de ma colonne de grille (rang = pr).
+    // Un bloc (k, jb) de la ligne du pivot ne sert qu'aux processus qui ont
+    // des blocs dans la colonne jb, c'est-à-dire à la colonne de grille
+    // jb % Pc : il est diffusé dans colComm, et pas à tout MPI_COMM_WORLD.
+    // De même, un bloc (ib, k) n'est diffusé que dans rowComm.
+    MPI_Comm gridComm, rowComm, colComm;
+    int periods[2] = {0, 0};
+    MPI_Cart_create(MPI_COMM_WORLD, 2, dims, periods, 0, &gridComm);
+    int coords[2];
+    MPI_Cart_coords(gridComm, rank, 2, coords);
+    int myPr = coords[0];
+    int myPc = coords[1];
+    int garderColonnes[2] = {0, 1};
+    int garderLignes[2] = {1, 0};
+    MPI_Cart_sub(gridComm, garderColonnes, &rowComm);
+    MPI_Cart_sub(gridComm, garderLignes, &colComm);
+
     // ===== Distribution des blocs =====
 
     // Ici je demande quels blocs appartiennent à CE processus.
@@ -307,137 +197,235 @@ int* ParallelFloydWarshallBlocks(int n, int* mat) {
     // Ici je prépare deux gros tableaux pour stocker, pour chaque bloc de la ligne k
 // et de la colonne k, les données dont j'ai besoin pour mettre à jour le reste.
 //
-// rowBlocks[jb] : contient le bloc D(k, jb)
-// colBlocks[ib] : contient le bloc D(ib, k)
-    vector<vector<int>> rowBlocks(nb, vector<int>(blockArea));
-    vector<vector<int>> colBlocks(nb, vector<int>(blockArea));
-    
+// rowBlocks[t][jb] : contient le bloc D(k, jb)
+// colBlocks[t][ib] : contient le bloc D(ib, k)
+//
+// avec t = k % nBuf. En mode lookahead, les blocs du pivot k+1 arrivent pendant
+// que la phase C du pivot k lit encore ceux du pivot k : il faut deux jeux.
+    const int nBuf = lookahead ? 2 : 1;
+    vector<vector<int>> rowBlocks[2];
+    vector<vector<int>> colBlocks[2];
+    for (int t = 0; t < nBuf; ++t) {
+        rowBlocks[t].assign(nb, vector<int>(blockArea));
+        colBlocks[t].assign(nb, vector<int>(blockArea));
+    }
+    vector<int> pivotBlock(blockArea, INF);
+
     // Buffers pour les communications asynchrones
     vector<MPI_Request> requests;
     requests.reserve(2 * nb);
 
-  // ===== Boucle principale sur les blocs pivots =====
-// kk parcourt les blocs diagonaux (k,k) en coordonnées de blocs.
-    for (int kk = 0; kk < nb; ++kk) {
-            // Je récupère le rang MPI qui possède le bloc pivot (kk,kk)
-        int pivotOwner = ownerOf(kk, kk, Pr, Pc);
-        int pivotLocalIdx = localIndex[kk * nb + kk];
-
-            // Je prépare un buffer pour le bloc pivot, initialisé à INF par défaut
-        vector<int> pivotBlock(blockArea, INF);
-        int bs = std::min(b, n - kk * b);
+    // Threads du rang pour les phases B et C (le thread principal en fait
+    // partie et reste le seul à appeler MPI).
+    ThreadPool pool(nThreads);
+    vector<StripTask> tasks;
+    vector<int> owned;
+
+    // ===== Phases A et B du pivot k =====
+    // Le bloc pivot est calculé et diffusé, puis mes blocs de la ligne et de
+    // la colonne du pivot sont mis à jour et leurs diffusions lancées. On ne
+    // les attend pas ici : requests est attendu juste avant la phase C du pivot k.
+    auto phasesAB = [&](int k) {
+        const int t = k % nBuf;
+            // Je récupère le rang MPI qui possède le bloc pivot (k,k)
+        int pivotOwner = ownerOf(k, k, Pr, Pc);
+        int pivotLocalIdx = localIndex[k * nb + k];
+        int bs = std::min(b, n - k * b);
 
         // ===== Phase A : Bloc pivot =====
-            // Seul le processus qui possède le bloc (kk,kk) fait le Floyd-Warshall local dessus.
+            // Seul le processus qui possède le bloc (k,k) fait le Floyd-Warshall local dessus.
 
         if (rank == pivotOwner && pivotLocalIdx != -1) {
             int* DkkLocal = &localData[pivotLocalIdx * blockArea];
                     // Je fais FW sur le bloc pivot uniquement (fw_block)
 
-            fw_block(DkkLocal, bs, b);
+            kernel.block(DkkLocal, bs, b);
                     // Puis je copie le bloc pivot mis à jour dans pivotBlock
 
             std::copy(DkkLocal, DkkLocal + blockArea, pivotBlock.begin());
         }
-            // Ensuite je diffuse le bloc pivot à tout le monde (broadcast classique).
-
-        MPI_Bcast(pivotBlock.data(), blockArea, MPI_INT, pivotOwner, MPI_COMM_WORLD);
-            // Et je le garde aussi comme "k-ième" bloc de ligne et de colonne
+            // Ensuite je diffuse le bloc pivot, mais seulement à ceux qui en ont besoin
+            // en phase B : la ligne de grille k % Pr (blocs (k,jb)) et la colonne
+            // de grille k % Pc (blocs (ib,k)). Les autres ne l'utilisent pas.
 
-        rowBlocks[kk] = pivotBlock;
-        colBlocks[kk] = pivotBlock;
+        if (myPr == k % Pr)
+            MPI_Bcast(pivotBlock.data(), blockArea, MPI_INT, k % Pc, rowComm);
+        if (myPc == k % Pc)
+            MPI_Bcast(pivotBlock.data(), blockArea, MPI_INT, k % Pr, colComm);
 
         // Phase B.1 : mise à jour de la LIGNE de blocs (k, jb)
     // Idée : le processus qui possède D(k,jb) le met à jour localement,
-    // puis on Ibcast ce bloc à tous les autres.
+    // puis on Ibcast ce bloc dans sa colonne de grille.
         requests.clear();
-        
+
+        // Je commence par mettre à jour tous mes blocs (k,jb) avec fw_row.
+        // Dans fw_row, les colonnes sont indépendantes : les threads se
+        // partagent les blocs par bandes de colonnes (16 entiers = une ligne
+        // de cache, pour ne pas écrire à deux dans la même).
+        owned.clear();
+        for (int jb = 0; jb < nb; ++jb) {
+            int localIdx = localIndex[k * nb + jb];
+            if (jb != k && localIdx != -1) owned.push_back(jb);
+        }
+        tasks.clear();
+        for (int jb : owned) {
+            addStrips(tasks, localIndex[k * nb + jb], std::min(b, n - jb * b),
+                      (int)owned.size(), pool.size(), b, 16);
+        }
+        pool.run(tasks.size(), [&](int, size_t i) {
+            const StripTask& st = tasks[i];
+            // Mise à jour des colonnes [off, off + len) du bloc D(k,J) avec le pivot D(k,k)
+            kernel.row(pivotBlock.data(), &localData[st.idx * blockArea] + st.off, bs, st.len, b);
+        });
+
         for (int jb = 0; jb < nb; ++jb) {
-            if (jb == kk) continue;  // on saute le pivot lui-même
+            if (jb == k) continue;  // on saute le pivot lui-même
 
-            int ownerRow = ownerOf(kk, jb, Pr, Pc);
-            int wJ = std::min(b, n - jb * b);
+            int ownerRow = ownerOf(k, jb, Pr, Pc);
 
-        // Si je suis le propriétaire du bloc (k,jb), je fais la mise à jour fw_row localement.
+        // Si je suis le propriétaire du bloc (k,jb), je le copie dans rowBlocks pour pouvoir le diffuser
             if (rank == ownerRow) {
-                int localIdx = localIndex[kk * nb + jb];
+                int localIdx = localIndex[k * nb + jb];
                 if (localIdx != -1) {
                     int* DkJ = &localData[localIdx * blockArea];
-                                    // Mise à jour du bloc D(k,J) avec le pivot D(k,k)
-                    fw_row(pivotBlock.data(), DkJ, bs, wJ, b);
-                                    // Je copie le résultat dans rowBlocks[jb] pour pouvoir le diffuser
-
-                    std::copy(DkJ, DkJ + blockArea, rowBlocks[jb].begin());
+                    std::copy(DkJ, DkJ + blockArea, rowBlocks[t][jb].begin());
                 }
             }
 
-              // Ici je lance un broadcast non bloquant du bloc D(k,jb)
-        // à partir de son propriétaire ownerRow.
-            MPI_Request req;
-            MPI_Ibcast(rowBlocks[jb].data(), blockArea, MPI_INT, 
-                      ownerRow, MPI_COMM_WORLD, &req);
-            requests.push_back(req);
+              // Ici je lance un broadcast non bloquant du bloc D(k,jb) à partir de
+        // son propriétaire ownerRow, qui est le processus k % Pr de la colonne
+        // de grille jb % Pc. Seuls les processus de cette colonne y participent.
+            if (myPc == jb % Pc) {
+                MPI_Request req;
+                MPI_Ibcast(rowBlocks[t][jb].data(), blockArea, MPI_INT,
+                          k % Pr, colComm, &req);
+                requests.push_back(req);
+            }
         }
 
-    // J'attends que toutes les diffusions de la ligne soient finies
-        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
-
        // ===== Phase B.2 : COLONNE de blocs (ib, k) =====
     // Même idée mais pour la colonne : pour chaque bloc (ib,k),
-    // le propriétaire fait fw_col puis on Ibcast.
-        requests.clear();
-        
+    // le propriétaire fait fw_col puis on Ibcast dans sa ligne de grille.
+    // (fw_col n'a pas besoin de la ligne : on n'attend pas ses diffusions.)
+
+        // Mes blocs (ib,k) avec fw_col : ici ce sont les lignes qui sont
+        // indépendantes, donc les threads se partagent des bandes de lignes.
+        owned.clear();
         for (int ib = 0; ib < nb; ++ib) {
-            if (ib == kk) continue; // on saute encore le pivot
+            int localIdx = localIndex[ib * nb + k];
+            if (ib != k && localIdx != -1) owned.push_back(ib);
+        }
+        tasks.clear();
+        for (int ib : owned) {
+            addStrips(tasks, localIndex[ib * nb + k], std::min(b, n - ib * b),
+                      (int)owned.size(), pool.size(), b, 1);
+        }
+        pool.run(tasks.size(), [&](int, size_t i) {
+            const StripTask& st = tasks[i];
+            // Mise à jour des lignes [off, off + len) du bloc D(I,k) avec le pivot D(k,k)
+            kernel.col(&localData[st.idx * blockArea] + st.off * b, pivotBlock.data(), st.len, bs, b);
+        });
 
-            int ownerCol = ownerOf(ib, kk, Pr, Pc);
-            int hI = std::min(b, n - ib * b);
-        // Si je possède le bloc (ib,k), je fais sa mise à jour fw_col.
+        for (int ib = 0; ib < nb; ++ib) {
+            if (ib == k) continue; // on saute encore le pivot
+
+            int ownerCol = ownerOf(ib, k, Pr, Pc);
+        // Si je possède le bloc (ib,k), je le copie dans colBlocks pour le diffuser
 
             if (rank == ownerCol) {
-                int localIdx = localIndex[ib * nb + kk];
+                int localIdx = localIndex[ib * nb + k];
                 if (localIdx != -1) {
                     int* Dik = &localData[localIdx * blockArea];
-                                    // Mise à jour du bloc D(I,k) avec le pivot D(k,k)
-                    fw_col(Dik, pivotBlock.data(), hI, bs, b);
-                                    // Je copie le résultat dans colBlocks[ib] pour le diffuser
-
-                    std::copy(Dik, Dik + blockArea, colBlocks[ib].begin());
+                    std::copy(Dik, Dik + blockArea, colBlocks[t][ib].begin());
                 }
             }
-        // Broadcast non bloquant du bloc (ib,k)
-            MPI_Request req;
-            MPI_Ibcast(colBlocks[ib].data(), blockArea, MPI_INT,
-                      ownerCol, MPI_COMM_WORLD, &req);
-            requests.push_back(req);
+        // Broadcast non bloquant du bloc (ib,k), depuis le processus k % Pc
+        // de la ligne de grille ib % Pr, seulement dans cette ligne
+            if (myPr == ib % Pr) {
+                MPI_Request req;
+                MPI_Ibcast(colBlocks[t][ib].data(), blockArea, MPI_INT,
+                          k % Pc, rowComm, &req);
+                requests.push_back(req);
+            }
         }
-    // J'attends que toutes les diffusions de la colonne soient finies
-        MPI_Waitall(requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+    };
 
   // ===== Phase C : Blocs internes =====
-    // Maintenant que j'ai :
-    //  - tous les D(I,k) dans colBlocks[ib]
-    //  - tous les D(k,J) dans rowBlocks[jb]
+    // Une fois que j'ai :
+    //  - tous les D(I,k) dans colBlocks[t][ib]
+    //  - tous les D(k,J) dans rowBlocks[t][jb]
+    //    (du moins ceux de ma ligne et de ma colonne de grille, les seuls dont j'ai besoin)
+    //
+    // je peux mettre à jour les blocs (I,J) qui ne sont ni dans la
+    // ligne k ni dans la colonne k, en utilisant fw_inner. garder(info)
+    // choisit lesquels (voir le lookahead plus bas).
     //
-    // Je peux mettre à jour tous les blocs (I,J) qui ne sont ni dans la
-    // ligne k ni dans la colonne k, en utilisant fw_inner.        for (int idx = 0; idx < numLocal; ++idx) {
-          for (int idx = 0; idx < numLocal; ++idx) { 
-    BlockInfo& info = localBlocks[idx];
-            int ib = info.bi;
-            int jb = info.bj;
- // Si le bloc est dans la ligne ou colonne du pivot,
-        // on l'a déjà traité avant.
-            if (ib == kk || jb == kk) continue;
-
-            int hI = std::min(b, n - ib * b);
-            int wJ = std::min(b, n - jb * b);
-
-            int* Dij = &localData[idx * blockArea];  // bloc (I,J) que je mets à jour
-            const int* Dik = colBlocks[ib].data();   // bloc (I,k)
-            const int* DkJ = rowBlocks[jb].data();  // bloc (k,J)
-
-                    // Mise à jour complète du bloc interne avec les chemins passant par k
-            fw_inner(Dik, DkJ, Dij, hI, wJ, bs, b);
+    // Les threads se partagent ces blocs, et quand il y a peu de blocs
+    // (une grande grille de processus, ou b = n / sqrt(p)) chaque bloc est
+    // coupé en bandes de lignes, multiples de la tuile du noyau.
+    //
+    // Avec avancer = true, des diffusions sont en cours dans requests : le
+    // thread principal (worker 0) appelle MPI_Testall entre deux bandes pour
+    // les faire avancer pendant le calcul.
+    auto phaseC = [&](int k, auto garder, bool avancer) {
+        const int t = k % nBuf;
+        int bs = std::min(b, n - k * b);
+        owned.clear();
+        for (int idx = 0; idx < numLocal; ++idx) {
+            const BlockInfo& info = localBlocks[idx];
+            // Si le bloc est dans la ligne ou colonne du pivot, on l'a déjà traité avant.
+            if (info.bi != k && info.bj != k && garder(info)) owned.push_back(idx);
+        }
+        tasks.clear();
+        for (int idx : owned) {
+            addStrips(tasks, idx, std::min(b, n - localBlocks[idx].bi * b),
+                      (int)owned.size(), pool.size(), b, kernel.blocking.mr);
+        }
+        pool.run(tasks.size(), [&](int w, size_t i) {
+            const StripTask& st = tasks[i];
+            const BlockInfo& info = localBlocks[st.idx];
+            int wJ = std::min(b, n - info.bj * b);
+
+            int* Dij = &localData[st.idx * blockArea] + st.off * b;     // lignes du bloc (I,J) que je mets à jour
+            const int* Dik = colBlocks[t][info.bi].data() + st.off * b;  // mêmes lignes du bloc (I,k)
+            const int* DkJ = rowBlocks[t][info.bj].data();               // bloc (k,J)
+
+                    // Mise à jour complète de la bande avec les chemins passant par k
+            kernel.inner(Dik, DkJ, Dij, st.len, wJ, bs, b, kernel.blocking);
+
+            if (avancer && w == 0) {
+                int fini;
+                MPI_Testall((int)requests.size(), requests.data(), &fini, MPI_STATUSES_IGNORE);
+            }
+        });
+    };
+    auto tous = [](const BlockInfo&) { return true; };
+
+  // ===== Boucle principale sur les blocs pivots =====
+// kk parcourt les blocs diagonaux (k,k) en coordonnées de blocs.
+//
+// Sans lookahead, chaque pivot attend la fin complète du précédent :
+// A(kk), B(kk), C(kk), puis A(kk+1)... La chaîne des pivots est alors sur le
+// chemin critique : pendant la phase A et les diffusions, tout le monde attend.
+//
+// Avec lookahead, la phase C du pivot kk commence par la ligne et la colonne
+// de blocs kk+1 (les seuls blocs dont les phases A et B de kk+1 ont besoin).
+// Le pivot kk+1 est alors calculé et ses blocs de ligne et de colonne diffusés
+// pendant que le reste de la phase C de kk tourne. Le résultat est le même :
+// chaque bloc reçoit les mêmes mises à jour, dans le même ordre de pivots.
+    phasesAB(0);
+    for (int kk = 0; kk < nb; ++kk) {
+    // J'attends que toutes les diffusions de la ligne et de la colonne kk soient finies
+        MPI_Waitall((int)requests.size(), requests.data(), MPI_STATUSES_IGNORE);
+
+        const int next = kk + 1;
+        if (lookahead && next < nb) {
+            phaseC(kk, [&](const BlockInfo& info) { return info.bi == next || info.bj == next; }, false);
+            phasesAB(next);
+            phaseC(kk, [&](const BlockInfo& info) { return info.bi != next && info.bj != next; }, true);
+        } else {
+            phaseC(kk, tous, false);
+            if (next < nb) phasesAB(next);
         }
     }
 
@@ -506,6 +494,10 @@ int* ParallelFloydWarshallBlocks(int n, int* mat) {
             }
         }
     }
+    MPI_Comm_free(&rowComm);
+    MPI_Comm_free(&colComm);
+    MPI_Comm_free(&gridComm);
+
 // Au final, seul le rang 0 renvoie la matrice complète.
 // Les autres processus renvoient nullptr, ils n'en ont pas besoin.
     return (rank == 0) ? D_final : nullptr;
@@ -15,10 +15,23 @@
  *   - Phase C : mise à jour des blocs internes (DIJ)
  *
  * Les communications font appel à MPI_Bcast et MPI_Ibcast afin de recouvrir
- * calculs et communications lorsque cela est possible. La matrice finale est
- * rassemblée sur le processus 0.
+ * calculs et communications lorsque cela est possible. Elles passent par les
+ * sous-communicateurs de ligne et de colonne d'une grille MPI_Cart : un bloc
+ * DkJ n'est reçu que par la colonne de processus qui en a besoin, un bloc DIk
+ * que par la ligne. La matrice finale est rassemblée sur le processus 0.
+ *
+ * Dans un rang, les phases B et C peuvent être partagées entre plusieurs
+ * threads (bandes de lignes ou de colonnes des blocs locaux) : on peut alors
+ * lancer un seul rang par nœud ou par socket, ce qui réduit le nombre de
+ * participants à chaque diffusion et le nombre de copies du bloc pivot.
+ *
+ * En mode lookahead, la ligne et la colonne de blocs k+1 sont mises à jour en
+ * premier dans la phase C du pivot k : le pivot k+1 et ses diffusions partent
+ * pendant le reste de cette phase C, au lieu d'attendre sa fin.
  */
 
+#include "MinPlusKernels.hpp"
+
 /**
  * @brief Algorithme parallèle de Floyd–Warshall utilisant une distribution en blocs.
  *
@@ -33,6 +46,11 @@
  *            l'élément (i, j) est à l'indice i * n + j.
  *            Cette matrice doit être identique sur tous les processus au moment
  *            de l'appel (diffusée préalablement).
+ * @param kernel Mises à jour des blocs à utiliser (voir selectMinPlusKernel).
+ * @param nThreads Threads de calcul du rang pour les phases B et C (1 = aucun
+ *                 thread en plus du thread principal, seul à appeler MPI).
+ * @param lookahead Calcule et diffuse le pivot k+1 pendant la phase C du pivot k
+ *                  (résultat identique, deux jeux de buffers de ligne/colonne).
  *
  * @return Sur le rang 0 : un pointeur vers la matrice finale des distances
  *         (n × n), allouée avec new[] et devant être libérée par l'appelant.
@@ -40,6 +58,7 @@
  *
  * @note La fonction doit être appelée après MPI_Init et avant MPI_Finalize.
  */
-int* ParallelFloydWarshallBlocks(int n, int* mat);
+int* ParallelFloydWarshallBlocks(int n, int* mat, const MinPlusKernel& kernel, int nThreads,
+                                 bool lookahead);
 
 #endif
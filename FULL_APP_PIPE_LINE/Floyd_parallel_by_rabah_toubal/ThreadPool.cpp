@@ -0,0 +1,64 @@
+#include "ThreadPool.hpp"
+
+ThreadPool::ThreadPool(int nThreads) : nThreads_(nThreads < 1 ? 1 : nThreads) {
+    for (int w = 1; w < nThreads_; ++w) {
+        workers_.emplace_back(&ThreadPool::workerLoop, this, w);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stop_ = true;
+    }
+    start_.notify_all();
+    for (std::thread& th : workers_) th.join();
+}
+
+void ThreadPool::run(std::size_t count, const std::function<void(int, std::size_t)>& body) {
+    if (nThreads_ <= 1 || count <= 1) {
+        for (std::size_t t = 0; t < count; ++t) body(0, t);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        body_ = &body;
+        count_ = count;
+        next_ = 0;
+        busy_ = nThreads_ - 1;
+        ++generation_;
+    }
+    start_.notify_all();
+
+    work(0);
+
+    // body vit sur la pile de l'appelant : on attend que plus personne ne l'utilise
+    std::unique_lock<std::mutex> lock(m_);
+    done_.wait(lock, [this] { return busy_ == 0; });
+    body_ = nullptr;
+}
+
+void ThreadPool::workerLoop(int worker) {
+    unsigned long seen = 0;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(m_);
+            start_.wait(lock, [&] { return stop_ || generation_ != seen; });
+            if (stop_) return;
+            seen = generation_;
+        }
+        work(worker);
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            if (--busy_ == 0) done_.notify_one();
+        }
+    }
+}
+
+void ThreadPool::work(int worker) {
+    std::size_t t;
+    while ((t = next_.fetch_add(1)) < count_) {
+        (*body_)(worker, t);
+    }
+}
@@ -0,0 +1,73 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file ThreadPool.hpp
+ * @brief Threads de calcul d'un rang MPI, gardés pendant tout Floyd–Warshall.
+ *
+ * Les phases B et C sont relancées à chaque bloc pivot (3 × nb fois) : créer
+ * des threads à chaque fois coûterait plus cher que certaines phases. Les
+ * threads sont donc créés une fois, puis endormis entre deux phases.
+ *
+ * Les tâches d'une phase (des bandes de blocs) ont presque toutes le même
+ * coût : chaque thread prend simplement la suivante dans un compteur atomique.
+ */
+
+/**
+ * @class ThreadPool
+ * @brief nThreads - 1 threads en attente, plus le thread appelant (thread 0).
+ */
+class ThreadPool {
+public:
+    /**
+     * @brief Lance nThreads - 1 threads (aucun avec nThreads <= 1).
+     */
+    explicit ThreadPool(int nThreads);
+
+    /**
+     * @brief Réveille les threads pour qu'ils se terminent, puis les attend.
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** @brief Nombre de threads, thread appelant compris. */
+    int size() const { return nThreads_; }
+
+    /**
+     * @brief Exécute body(worker, t) pour t = 0 .. count - 1 et attend la fin.
+     *
+     * Le thread appelant travaille aussi (worker 0). Avec un seul thread, la
+     * boucle est faite dans l'ordre, sans synchronisation. body ne doit
+     * appeler MPI que pour worker == 0 (seul le thread principal communique).
+     */
+    void run(std::size_t count, const std::function<void(int, std::size_t)>& body);
+
+private:
+    void workerLoop(int worker);
+    void work(int worker);
+
+    int nThreads_;
+    std::vector<std::thread> workers_;
+
+    std::mutex m_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    const std::function<void(int, std::size_t)>* body_ = nullptr;
+    std::size_t count_ = 0;
+    std::atomic<std::size_t> next_{0};
+    unsigned long generation_ = 0;   // incrémenté à chaque run()
+    int busy_ = 0;                   // threads pas encore revenus de la phase
+    bool stop_ = false;
+};
+
+#endif // THREAD_POOL_HPP
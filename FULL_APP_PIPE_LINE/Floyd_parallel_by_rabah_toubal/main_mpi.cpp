@@ -4,8 +4,9 @@
  * @file main_mpi.cpp
  * @brief Point d'entrée du programme MPI pour le calcul des plus courts chemins (Floyd–Warshall par blocs).
  *
- * Le rang 0 lit un graphe au format Graphviz (.dot), construit la matrice d'adjacence
- * correspondante, puis diffuse cette matrice à tous les processus MPI. L'algorithme
+ * Le rang 0 lit un graphe au format Graphviz (.dot) ou au format binaire CSR écrit
+ * par build_dot (--csr=F), construit la matrice d'adjacence correspondante, puis
+ * diffuse cette matrice à tous les processus MPI. L'algorithme
  * parallèle de Floyd–Warshall par blocs est ensuite lancé via ParallelFloydWarshallBlocks().
  *
  * À la fin du calcul, le rang 0 :
@@ -18,9 +19,13 @@
 #include <iostream>
 #include <string>
 #include <map>
+#include <algorithm>
+#include <cstdio>
+#include <thread>
 
 #include "Utils.hpp"
 #include "ForGraphMPI.hpp"
+#include "CsrGraph.hpp"
 #include "ParallelFWBlocks.hpp"
 
 using namespace std;
@@ -31,8 +36,20 @@ using namespace std;
  * Usage :
  * @code
  *   mpirun -np <nb_processus> ./main_mpi fichier.dot
+ *   mpirun -np <nb_processus> ./main_mpi fichier.csr
+ *   mpirun -np <nb_processus> ./main_mpi fichier.csr --simd=avx2
  * @endcode
  *
+ * Le format est reconnu à l'en-tête du fichier, pas à son extension.
+ * --simd=auto|generic|avx2|avx512 force le jeu d'instructions des mises à jour
+ * de blocs (par défaut, le meilleur supporté par chaque processeur).
+ * --blocking=KC,MC,NC remplace le découpage de la phase C calculé d'après les
+ * caches (voir MinPlusKernels.hpp) ; 0 garde la valeur calculée.
+ * --threads=N partage les phases B et C de chaque rang entre N threads
+ * (défaut 1, 0 = autant que de cœurs visibles).
+ * --lookahead calcule et diffuse chaque pivot pendant la fin de la phase C du
+ * pivot précédent (voir ParallelFWBlocks.hpp).
+ *
  * @param argc 
  * @param argv 
  *
@@ -40,7 +57,10 @@ using namespace std;
  */
 int main(int argc, char* argv[]) {
 
-    MPI_Init(&argc, &argv);
+    // Seul le thread principal appelle MPI (les threads de calcul ne font que
+    // des mises à jour de blocs), donc MPI_THREAD_FUNNELED suffit.
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
 
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
@@ -48,12 +68,63 @@ int main(int argc, char* argv[]) {
 
 
     // Vérification des arguments
-    if (argc != 2) {
+    MinPlusLevel simd = MinPlusLevel::Auto;
+    const char* simdArg = "";
+    int blocking[3] = {0, 0, 0};   // kc, mc, nc (0 = valeur calculée)
+    int nThreads = 1;
+    bool lookahead = false;
+    bool argsOk = (argc >= 2);
+    for (int a = 2; a < argc && argsOk; ++a) {
+        string arg = argv[a];
+        if (arg.rfind("--simd=", 0) == 0) simdArg = argv[a];
+        if (arg == "--simd=auto")         simd = MinPlusLevel::Auto;
+        else if (arg == "--simd=generic") simd = MinPlusLevel::Generic;
+        else if (arg == "--simd=avx2")    simd = MinPlusLevel::AVX2;
+        else if (arg == "--simd=avx512")  simd = MinPlusLevel::AVX512;
+        else if (arg.rfind("--blocking=", 0) == 0) {
+            argsOk = sscanf(argv[a], "--blocking=%d,%d,%d", &blocking[0], &blocking[1], &blocking[2]) == 3
+                     && blocking[0] >= 0 && blocking[1] >= 0 && blocking[2] >= 0;
+        }
+        else if (arg.rfind("--threads=", 0) == 0) {
+            argsOk = sscanf(argv[a], "--threads=%d", &nThreads) == 1 && nThreads >= 0;
+        }
+        else if (arg == "--lookahead")    lookahead = true;
+        else argsOk = false;
+    }
+    if (!argsOk) {
+        if (rank == 0)
+            cout << "Usage : mpirun -np X<=6 ./main_mpi fichier.dot|fichier.csr"
+                 << " [--simd=auto|generic|avx2|avx512] [--blocking=KC,MC,NC] [--threads=N] [--lookahead]\n";
+        MPI_Finalize();
+        return EXIT_FAILURE;
+    }
+
+    // Un jeu d'instructions forcé doit exister sur les processeurs de tous les rangs
+    int supported = cpuSupportsMinPlus(simd) ? 1 : 0;
+    int allSupported = 0;
+    MPI_Allreduce(&supported, &allSupported, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    if (!allSupported) {
         if (rank == 0)
-            cout << "Usage : mpirun -np X<=6 ./main_mpi fichier.dot\n";
+            cout << "Jeu d'instructions non supporte par tous les processeurs : " << simdArg << "\n";
         MPI_Finalize();
         return EXIT_FAILURE;
     }
+    MinPlusKernel kernel = selectMinPlusKernel(simd);
+    if (blocking[0] > 0) kernel.blocking.kc = blocking[0];
+    // mc et nc restent des multiples de la tuile de registres
+    if (blocking[1] > 0) kernel.blocking.mc = std::max(1, blocking[1] / kernel.blocking.mr) * kernel.blocking.mr;
+    if (blocking[2] > 0) kernel.blocking.nc = std::max(1, blocking[2] / kernel.blocking.nr) * kernel.blocking.nr;
+
+    if (nThreads == 0) {
+        nThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    // Sans MPI_THREAD_FUNNELED, MPI ne supporte pas d'autres threads dans le
+    // processus : on reste sur le thread principal.
+    if (provided < MPI_THREAD_FUNNELED && nThreads > 1) {
+        if (rank == 0)
+            cout << "[WARN] MPI_THREAD_FUNNELED non fourni par MPI : --threads ignore (1 thread par rang)\n";
+        nThreads = 1;
+    }
 
     char* file_name = argv[1];
 
@@ -65,7 +136,13 @@ int main(int argc, char* argv[]) {
     // Rank 0 lit le graphe
     // -----------------------------
     if (rank == 0) {
-        mat_adjacence = lectureGrapheMPI(file_name, &nb_nodes, &my_nodes);
+        double t_lecture = MPI_Wtime();
+        if (estGrapheCSR(file_name))
+            mat_adjacence = lectureGrapheCSR(file_name, &nb_nodes);
+        else
+            mat_adjacence = lectureGrapheMPI(file_name, &nb_nodes, &my_nodes);
+        cout << ">>> Temps de lecture du graphe : "
+             << (MPI_Wtime() - t_lecture) * 1000.0 << " ms" << endl;
 
         // Debug éventuel : affichage de la matrice d'adjacence
         // cout << "=== Matrice d'adjacence ===\n";
@@ -90,7 +167,7 @@ int main(int argc, char* argv[]) {
     MPI_Barrier(MPI_COMM_WORLD);              // Synchronisation de tous les rangs
     double t_start = MPI_Wtime();
 
-    int* Dk_final = ParallelFloydWarshallBlocks(nb_nodes, mat_adjacence);
+    int* Dk_final = ParallelFloydWarshallBlocks(nb_nodes, mat_adjacence, kernel, nThreads, lookahead);
 
     MPI_Barrier(MPI_COMM_WORLD);              // On attend que tout le monde ait fini
     double t_end = MPI_Wtime();
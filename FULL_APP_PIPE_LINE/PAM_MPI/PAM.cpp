@@ -38,14 +38,17 @@ static const int INF = 100000;
  * @param medoids      Liste des indices de médioïdes.
  * @param clusterOf    Vecteur de sortie : clusterOf[i] = indice du médioïde associé.
  * @param distToMedoid Vecteur de sortie : distToMedoid[i] = distance au médioïde.
+ * @param weight       Poids des sommets (vide = 1 partout).
  *
- * @return La somme totale des distances de chaque sommet à son médioïde.
+ * @return La somme totale des distances de chaque sommet à son médioïde
+ *         (multipliées par les poids).
  */
 static long long computeCostAndAssign(const std::vector<int>& dist,
                                       int n,
                                       const std::vector<int>& medoids,
                                       std::vector<int>& clusterOf,
-                                      std::vector<int>& distToMedoid)
+                                      std::vector<int>& distToMedoid,
+                                      const std::vector<int>& weight)
 {
     int k = (int)medoids.size();
     long long totalCost = 0;
@@ -70,7 +73,7 @@ static long long computeCostAndAssign(const std::vector<int>& dist,
         //  - la distance de i à son medioide.
         clusterOf[i]    = bestMedoidIdx;
         distToMedoid[i] = bestDist;
-        totalCost      += bestDist;
+        totalCost      += (long long)bestDist * (weight.empty() ? 1 : weight[i]);
     }
     // Je renvoie la somme des distances de tous les sommets
     // à leur medioide respectif.
@@ -87,10 +90,12 @@ static long long computeCostAndAssign(const std::vector<int>& dist,
  *   - accumule sa contribution dans localCost.
  *
  * Un MPI_Allreduce(MPI_SUM) donne le coût total global.
+ * Avec des poids, la distance du sommet i compte weight[i] fois.
  */
 static long long computeCostDistributed(const std::vector<int>& dist,
                                         int n,
-                                        const std::vector<int>& medoids)
+                                        const std::vector<int>& medoids,
+                                        const std::vector<int>& weight)
 {
     
     int rank, size;
@@ -123,9 +128,10 @@ static long long computeCostDistributed(const std::vector<int>& dist,
                 bestDist = d;
             }
         }
-        // J'ajoute la meilleure distance pour ce sommet à mon coût local.
+        // J'ajoute la meilleure distance pour ce sommet à mon coût local
+        // (autant de fois que de séquences regroupées dans ce sommet).
 
-        localCost += bestDist;
+        localCost += (long long)bestDist * (weight.empty() ? 1 : weight[i]);
     }
 
      // Réduction pour obtenir le coût global
@@ -151,7 +157,7 @@ static long long computeCostDistributed(const std::vector<int>& dist,
 // Le calcul de coût est distribué (computeCostDistributed),
 // mais la logique "qui est le meilleur échange ?" est centralisée sur le rang 0.
 //
-PAMResult runPAM_MPI(const std::vector<int>& dist, int n, int k) {
+PAMResult runPAM_MPI(const std::vector<int>& dist, int n, int k, const std::vector<int>& weight) {
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
@@ -188,7 +194,7 @@ PAMResult runPAM_MPI(const std::vector<int>& dist, int n, int k) {
     MPI_Bcast(res.medoids.data(), k, MPI_INT, 0, MPI_COMM_WORLD);
 
     // Je calcule le coût initial de ces medioides avec la version distribuée.
-    long long bestCost = computeCostDistributed(dist, n, res.medoids);
+    long long bestCost = computeCostDistributed(dist, n, res.medoids, weight);
 
     // -----------------------------
     // 2) Boucles d'amélioration : on teste tous les échanges (m, h)
@@ -224,7 +230,7 @@ PAMResult runPAM_MPI(const std::vector<int>& dist, int n, int k) {
 
                // Je demande le coût global de cette configuration newMedoids.
                 // computeCostDistributed utilise tous les rangs pour calculer ce coût.
-                long long newCost = computeCostDistributed(dist, n, newMedoids);
+                long long newCost = computeCostDistributed(dist, n, newMedoids, weight);
                
                 // Seul le rang 0 décide si c'est mieux ou pas.
                 if (rank == 0 && newCost < bestCostThisPass) {
@@ -270,7 +276,8 @@ PAMResult runPAM_MPI(const std::vector<int>& dist, int n, int k) {
         long long finalCost = computeCostAndAssign(dist, n,
                                                    res.medoids,
                                                    res.clusterOf,
-                                                   res.distToMedoid);
+                                                   res.distToMedoid,
+                                                   weight);
         res.totalCost = finalCost;
     } 
 
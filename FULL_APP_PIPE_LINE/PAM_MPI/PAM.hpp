@@ -20,12 +20,13 @@
  *                  auquel i est affecté (c'est l'indice du méd(oïde) dans le tableau medoids)
  * - distToMedoid[i] : distance de i à son médioïde le plus proche
  * - totalCost : somme des distances de tous les sommets à leur médioïde
+ *               (chacune multipliée par le poids du sommet s'il y en a)
  */
 struct PAMResult {
     std::vector<int> medoids;       /**< Indices des médioïdes choisis. */
     std::vector<int> clusterOf;     /**< Pour chaque sommet i, indice du cluster (0..k-1). */
     std::vector<int> distToMedoid;  /**< Distance entre chaque sommet et son médioïde. */
-    long long totalCost = 0;        /**< Coût total (somme des distances au médioïde). */
+    long long totalCost = 0;        /**< Coût total (somme des distances au médioïde, pondérée). */
 };
 
 /**
@@ -42,10 +43,14 @@ struct PAMResult {
  *             dist[i * n + j] contient la distance entre i et j.
  * @param n    Nombre total de sommets.
  * @param k    Nombre de groupes / médioïdes.
+ * @param weight Poids de chaque sommet (taille n), identique sur tous les rangs :
+ *               un sommet qui regroupe w séquences identiques compte w fois dans
+ *               le coût. Vide = tous les poids valent 1.
  *
  * @return Sur le rang 0 : résultat complet (médioïdes, clusters, coût).
  *         Sur les autres rangs : seul totalCost est rempli, le reste n’est pas utilisé.
  */
-PAMResult runPAM_MPI(const std::vector<int>& dist, int n, int k);
+PAMResult runPAM_MPI(const std::vector<int>& dist, int n, int k,
+                     const std::vector<int>& weight = std::vector<int>());
 
 #endif 
@@ -57,18 +57,80 @@ std::vector<int> readDistanceMatrix(const std::string& filename, int& n_out) {
     return dist;
 }
 
+/**
+ * @brief Lit le fichier de groupes de séquences (build_dot --dedup).
+ */
+SequenceGroups readSequenceGroups(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in) {
+        throw std::runtime_error("Impossible d'ouvrir le fichier de groupes: " + filename);
+    }
+
+    // On saute les commentaires, puis on lit tout comme une suite d'entiers.
+    std::stringstream body;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line[0] == '#') continue;
+        body << line << "\n";
+    }
+
+    SequenceGroups g;
+    int nVertices = 0;
+    if (!(body >> g.nSequences >> nVertices) || g.nSequences < 0 || nVertices < 0) {
+        throw std::runtime_error("Lecture du nombre de sequences / sommets echouee dans " + filename);
+    }
+    g.weight.resize(nVertices);
+    g.members.resize(nVertices);
+
+    int total = 0;
+    std::vector<char> seen(g.nSequences, 0);
+    for (int u = 0; u < nVertices; ++u) {
+        int id, m;
+        if (!(body >> id >> m) || id != u || m <= 0) {
+            std::ostringstream oss;
+            oss << "Groupe " << u << " mal forme dans " << filename;
+            throw std::runtime_error(oss.str());
+        }
+        g.weight[u] = m;
+        g.members[u].resize(m);
+        for (int t = 0; t < m; ++t) {
+            int s;
+            if (!(body >> s) || s < 0 || s >= g.nSequences || seen[s]) {
+                std::ostringstream oss;
+                oss << "Sequence invalide dans le groupe " << u << " de " << filename;
+                throw std::runtime_error(oss.str());
+            }
+            g.members[u][t] = s;
+            seen[s] = 1;
+        }
+        total += m;
+    }
+    if (total != g.nSequences) {
+        std::ostringstream oss;
+        oss << "Les groupes de " << filename << " contiennent " << total
+            << " sequences au lieu de " << g.nSequences;
+        throw std::runtime_error(oss.str());
+    }
+
+    return g;
+}
+
 /**
  * @brief Écrit un résultat PAM détaillé dans un fichier texte.
  */
-void writePAMResult(const std::string& filename, const PAMResult& res) {
+void writePAMResult(const std::string& filename, const PAMResult& res,
+                    const SequenceGroups* groups) {
     std::ofstream out(filename);
     if (!out) {
         throw std::runtime_error("Impossible d'ouvrir le fichier de resultat PAM: " + filename);
     }
 
-    int n = (int)res.clusterOf.size();
+    int n = groups ? groups->nSequences : (int)res.clusterOf.size();
     int k = (int)res.medoids.size();
 
+    // Indice (dans le FASTA) de la séquence qui représente le sommet u.
+    auto seqOf = [groups](int u) { return groups ? groups->members[u][0] : u; };
+
     out << "# PAM results\n";
     out << "# n = " << n << "\n";
     out << "# k = " << k << "\n";
@@ -76,18 +138,38 @@ void writePAMResult(const std::string& filename, const PAMResult& res) {
 
     out << "# medoids:\n";
     for (int m = 0; m < k; ++m) {
-        out << res.medoids[m] << (m + 1 < k ? ' ' : '\n');
+        out << seqOf(res.medoids[m]) << (m + 1 < k ? ' ' : '\n');
     }
     out << "\n";
 
     out << "# columns: vertex cluster medoid dist\n";
 
-    for (int i = 0; i < n; ++i) {
-        int cluster = res.clusterOf[i];      // indice du cluster (0..k-1)
-        int medoid  = res.medoids[cluster];  // indice du sommet médioïde
-        int d       = res.distToMedoid[i];
+    if (!groups) {
+        for (int i = 0; i < n; ++i) {
+            int cluster = res.clusterOf[i];      // indice du cluster (0..k-1)
+            int medoid  = res.medoids[cluster];  // indice du sommet médioïde
+            int d       = res.distToMedoid[i];
+
+            out << i << " "
+                << cluster << " "
+                << medoid << " "
+                << d << "\n";
+        }
+        return;
+    }
+
+    // Séquences dédupliquées : chaque copie prend le groupe de son sommet.
+    std::vector<int> vertexOf(n, -1);
+    for (int u = 0; u < (int)groups->members.size(); ++u) {
+        for (int s : groups->members[u]) vertexOf[s] = u;
+    }
+    for (int s = 0; s < n; ++s) {
+        int u       = vertexOf[s];
+        int cluster = res.clusterOf[u];
+        int medoid  = seqOf(res.medoids[cluster]);
+        int d       = res.distToMedoid[u];
 
-        out << i << " "
+        out << s << " "
             << cluster << " "
             << medoid << " "
             << d << "\n";
@@ -41,6 +41,38 @@ void affichage(const int* tab, int n, int m, int format = 4);
  */
 std::vector<int> readDistanceMatrix(const std::string& filename, int& n_out);
 
+/**
+ * @struct SequenceGroups
+ * @brief Séquences regroupées par sommet (fichier écrit par build_dot --dedup).
+ *
+ * Le sommet u représente weight[u] séquences identiques, d'indices members[u]
+ * dans le FASTA (la première est celle qui a donné son nom au sommet).
+ */
+struct SequenceGroups {
+    int nSequences = 0;                    /**< Nombre de séquences du FASTA. */
+    std::vector<int> weight;               /**< Multiplicité de chaque sommet. */
+    std::vector<std::vector<int>> members; /**< Séquences de chaque sommet. */
+};
+
+/**
+ * @brief Lit le fichier de groupes écrit par build_dot --dedup.
+ *
+ * Format attendu :
+ * @code
+ *   # sequences sommets
+ *   2000 1990
+ *   # sommet multiplicite sequences...
+ *   0 1 0
+ *   1 2 1 57
+ *   ...
+ * @endcode
+ *
+ * Les lignes qui commencent par '#' sont ignorées.
+ *
+ * @throw std::runtime_error si le fichier est absent ou mal formé.
+ */
+SequenceGroups readSequenceGroups(const std::string& filename);
+
 /**
  * @brief Écrit le résultat de PAM dans un fichier texte.
  *
@@ -60,9 +92,15 @@ std::vector<int> readDistanceMatrix(const std::string& filename, int& n_out);
  *   ...
  * @endcode
  *
+ * Avec des groupes (séquences dédupliquées), on écrit une ligne par séquence
+ * du FASTA et non par sommet : n est le nombre de séquences, et les médioïdes
+ * sont donnés par l'indice de la séquence qui représente leur sommet.
+ *
  * @param filename Nom du fichier de sortie.
  * @param res      Résultat PAM à écrire.
+ * @param groups   Groupes de séquences, ou nullptr (un sommet = une séquence).
  */
-void writePAMResult(const std::string& filename, const PAMResult& res);
+void writePAMResult(const std::string& filename, const PAMResult& res,
+                    const SequenceGroups* groups = nullptr);
 
 #endif // UTILS_HPP
@@ -5,6 +5,9 @@
  *
  * Le rang 0 lit une matrice de distances depuis un fichier texte, diffuse cette
  * matrice à tous les processus, puis lance la version MPI de PAM (runPAM_MPI).
+ * Si build_dot a regroupé les séquences identiques (--dedup), le fichier de
+ * groupes donne le poids de chaque sommet, et le résultat est réécrit avec
+ * une ligne par séquence.
  * À la fin, le rang 0 affiche le coût final, les médioïdes, le temps d'exécution,
  * et écrit un fichier de sortie contenant la partition.
  */
@@ -13,6 +16,7 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <stdexcept>
 
 #include "Utils.hpp"
 #include "PAM.hpp"
@@ -22,11 +26,12 @@
  *
  * Usage :
  * @code
- *   mpirun -np <nb_processus> ./pam_mpi fichier_distances.txt
+ *   mpirun -np <nb_processus> ./pam_mpi fichier_distances.txt [fichier_groupes.txt]
  * @endcode
  *
  * @param argc Nombre d'arguments de la ligne de commande.
- * @param argv Tableau d'arguments (argv[1] doit contenir le fichier de distances).
+ * @param argv Tableau d'arguments (argv[1] doit contenir le fichier de distances,
+ *             argv[2], optionnel, le fichier de groupes écrit par build_dot --dedup).
  * @return 0 en cas de succès, une valeur non nulle en cas d'erreur.
  */
 int main(int argc, char** argv) {
@@ -37,17 +42,30 @@ int main(int argc, char** argv) {
 
     // ---------- NOMS EN DUR ICI ----------
     const std::string distFile = argv[1];
+    const std::string groupsFile = (argc > 2) ? argv[2] : "";
     const std::string outFile  = "../../DATA/resultat_pam_parallel.txt";                  // résultat PAM
     const int k = 4;                                                                   // nombre de clusters
     // -------------------------------------
 
     int n = 0;
     std::vector<int> dist;
+    SequenceGroups groups;
+    int weighted = 0;
 
     if (rank == 0) {
         try {
             dist = readDistanceMatrix(distFile, n);
             std::cout << "\n\nLecture de la matrice de distances: n = " << n << "\n";
+            if (!groupsFile.empty()) {
+                groups = readSequenceGroups(groupsFile);
+                if ((int)groups.weight.size() != n) {
+                    throw std::runtime_error("le fichier de groupes " + groupsFile
+                                             + " ne correspond pas a la matrice (nombre de sommets)");
+                }
+                weighted = 1;
+                std::cout << "Groupes de sequences : " << groups.nSequences
+                          << " sequences sur " << n << " sommets\n";
+            }
             std::cout << "Execution de PAM MPI avec k = " << k << " ...\n";
         } catch (const std::exception& e) {
             std::cerr << "Erreur (rang 0) : " << e.what() << "\n";
@@ -66,6 +84,15 @@ int main(int argc, char** argv) {
     // Diffuser la matrice complète
     MPI_Bcast(dist.data(), n * n, MPI_INT, 0, MPI_COMM_WORLD);
 
+    // Diffuser les poids des sommets (multiplicités), s'il y en a
+    MPI_Bcast(&weighted, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (weighted) {
+        if (rank != 0) {
+            groups.weight.resize(n);
+        }
+        MPI_Bcast(groups.weight.data(), n, MPI_INT, 0, MPI_COMM_WORLD);
+    }
+
     // ------------------------------------------------------------------
     // Mesure du temps d'exécution de PAM MPI
     // ------------------------------------------------------------------
@@ -73,7 +100,7 @@ int main(int argc, char** argv) {
     double t0 = MPI_Wtime();                // temps de départ (en secondes)
 
     // Exécuter l'algorithme PAM en parallèle
-    PAMResult res = runPAM_MPI(dist, n, k);
+    PAMResult res = runPAM_MPI(dist, n, k, groups.weight);
 
     MPI_Barrier(MPI_COMM_WORLD);            // on attend que tout le monde ait fini
     double t1 = MPI_Wtime();                // temps de fin
@@ -92,7 +119,7 @@ int main(int argc, char** argv) {
                   << elapsed_ms << " ms\n\n";
 
         try {
-            writePAMResult(outFile, res);
+            writePAMResult(outFile, res, weighted ? &groups : nullptr);
             std::cout << "Resultats ecrits dans " << outFile << "\n";
         } catch (const std::exception& e) {
             std::cerr << "Erreur d'ecriture du resultat: " << e.what() << "\n";
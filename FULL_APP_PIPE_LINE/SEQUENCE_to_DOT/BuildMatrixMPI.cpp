@@ -8,7 +8,7 @@
  *
  * Ce programme :
  *   - lit un fichier FASTA contenant des séquences d'ARN (rang 0),
- *   - vérifie que toutes les séquences ont la même longueur,
+ *   - vérifie que toutes les séquences ont la même longueur (sauf en distance d'édition),
  *   - diffuse les séquences à tous les processus MPI,
  *   - calcule en parallèle toutes les distances de Hamming entre les séquences,
  *   - rassemble la matrice de distances sur le rang 0,
@@ -25,6 +25,25 @@
 #include <string>
 #include <stdexcept>
 #include <algorithm>
+#include <climits>
+#include <thread>
+
+#include "EdgeList.hpp"
+#include "CsrGraph.hpp"
+#include "Dedup.hpp"
+#include "DotWriter.hpp"
+#include "EditDistance.hpp"
+#include "FastaReader.hpp"
+#include "GemmHamming.hpp"
+#include "HammingKernels.hpp"
+#include "LshFilter.hpp"
+#include "Options.hpp"
+#include "PackedSeqs.hpp"
+#include "RingExchange.hpp"
+#include "Tiles.hpp"
+#include "TileScheduler.hpp"
+#include "WeightedDistance.hpp"
+#include "WorkStealing.hpp"
 
 /**
  * @brief Lit un fichier FASTA "simple" et renvoie la liste des séquences.
@@ -70,85 +89,6 @@ static std::vector<std::string> readFasta(const std::string& filename) {
     return seqs;
 }
 
-/**
- * @brief Calcule la distance de Hamming entre deux séquences de même longueur.
- *
- * La distance de Hamming est le nombre de positions i telles que a[i] != b[i].
- *
- * @param a Pointeur vers la première séquence de longueur L.
- * @param b Pointeur vers la deuxième séquence de longueur L.
- * @param L Longueur des deux séquences.
- *
- * @return La distance de Hamming entre a et b.
- */
-static int hamming(const char* a, const char* b, int L) {
-    int d = 0;
-    for (int i = 0; i < L; ++i) {
-        if (a[i] != b[i]) ++d;
-    }
-    return d;
-}
-
-/**
- * @brief Écrit un graphe pondéré non orienté au format DOT à partir d'une matrice de distances.
- *
- * On génère un graphe de la forme :
- * @code
- *   graph graphe_pondere {
- *     A1 [label="0"];
- *     A2 [label="1"];
- *     ...
- *     A1 -- A2 [label="d", weight=d];
- *     ...
- *   }
- * @endcode
- *
- * Pour chaque paire (i, j) avec i < j, une arête est créée uniquement si
- * la distance d(i, j) est strictement inférieure à epsilon.
- *
- * @param filename Nom du fichier DOT à générer.
- * @param dist     Matrice des distances de taille n × n, stockée à plat (row-major).
- *                 L'élément (i, j) est à l'indice i * n + j.
- * @param n        Nombre de séquences / sommets du graphe.
- * @param epsilon  Seuil sur la distance de Hamming : on ne met une arête que si d < epsilon.
- *
- * @throw std::runtime_error si le fichier ne peut pas être ouvert en écriture.
- */
-static void writeDotGraph(const std::string& filename,
-                          const std::vector<int>& dist,
-                          int n,
-                          int epsilon)
-{
-    std::ofstream out(filename);
-    if (!out) {
-        throw std::runtime_error("Impossible d'ouvrir " + filename + " en écriture");
-    }
-
-    out << "graph graphe_pondere {\n";
-    out << "    node [shape=circle, style=filled, color=lightyellow, fontcolor=black];\n";
-    out << "    edge [color=black, fontcolor=blue];\n\n";
-
-    // Déclaration des sommets : A1, A2, ..., An
-    // label = indice de la séquence (0,1,2,...)
-    for (int i = 0; i < n; ++i) {
-        out << "    A" << (i + 1) << " [label=\"" << i << "\"];\n";
-    }
-    out << "\n    // Les aretes avec poids (distance de Hamming < epsilon)\n";
-
-    // Arêtes non orientées : i < j
-    for (int i = 0; i < n; ++i) {
-        for (int j = i + 1; j < n; ++j) {
-            int d = dist[i * n + j];
-            if (d < epsilon) {
-                out << "    A" << (i + 1) << " -- A" << (j + 1)
-                    << " [label=\"" << d << "\", weight=" << d << "];\n";
-            }
-        }
-    }
-
-    out << "}\n";
-}
-
 /**
  * @brief Programme principal MPI : construction de la matrice de distances et du graphe DOT.
  *
@@ -156,103 +96,478 @@ static void writeDotGraph(const std::string& filename,
  *   - rang 0 lit un fichier FASTA et vérifie que toutes les séquences ont la même longueur,
  *   - n (nombre de séquences) et L (longueur des séquences) sont diffusés à tous,
  *   - les séquences sont diffusées à tous les rangs sous forme de tableau contigu,
- *   - chaque rang calcule un sous-ensemble de lignes de la matrice des distances
- *     de Hamming (d(i, j) pour ses lignes i),
- *   - le rang 0 rassemble les sous-matrices pour reconstruire la matrice n × n complète,
- *   - le rang 0 écrit un fichier DOT pondéré (utilisé ensuite par l'algorithme de Floyd–Warshall),
+ *   - le triangle supérieur des paires i < j est découpé en tuiles T × T, et chaque
+ *     rang calcule une suite de tuiles (toutes les parts ont le même nombre de paires),
+ *   - chaque rang ne garde que les paires avec d < epsilon, sous forme d'arêtes (i, j, d),
+ *   - le rang 0 rassemble ces listes d'arêtes (MPI_Gatherv),
+ *   - les rangs écrivent ensemble un fichier DOT pondéré (utilisé ensuite par l'algorithme
+ *     de Floyd–Warshall), chacun sa tranche d'arêtes avec MPI-IO (voir DotWriter.hpp),
  *   - le temps total (calcul + rassemblement) est mesuré avec MPI_Wtime().
  *
  * Usage typique :
  * @code
- *   mpirun -np <nb_processus> ./build_matrix_mpi dataset_500seq.fa
+ *   mpirun -np <nb_processus> ./build_matrix_mpi dataset_500seq.fa [--kernel=packed|char|gemm]
+ *                                                [--simd=auto|scalar|sse4.2|avx2|avx512]
+ *                                                [--bounded] [--distance=hamming|edit|weighted]
+ *                                                [--ts-tv=TS,TV] [--position-weights=F]
+ *                                                [--lsh=B,R] [--lsh-check] [--epsilon=E1,E2,...]
+ *                                                [--ring]
  * @endcode
  *
+ * Avec le noyau "packed" (par défaut), les séquences sont codées sur 2 bits par base
+ * sur le rang 0 avant la diffusion (voir PackedSeqs.hpp) ; avec "char", le tableau
+ * brut est diffusé et comparé avec le noyau vectorisé choisi par chaque rang
+ * (voir HammingKernels.hpp). Avec --bounded, le calcul d'une distance s'arrête dès
+ * qu'elle atteint epsilon, puisque ces paires ne deviennent pas des arêtes.
+ * Avec "gemm", les séquences restent codées sur 2 bits, et chaque tuile est
+ * calculée comme un produit de matrices sur leur codage one-hot (voir GemmHamming.hpp).
+ * Avec --distance=edit, les séquences peuvent avoir des longueurs différentes et
+ * la distance est la distance d'édition, bornée par epsilon (voir EditDistance.hpp).
+ * Avec --distance=weighted, une transition coûte TS, une transversion TV, et
+ * chaque position peut avoir son poids (voir WeightedDistance.hpp).
+ * Avec --lsh=B,R, seules les paires candidates d'un filtre LSH sont vérifiées
+ * (voir LshFilter.hpp) au lieu des n(n-1)/2 paires.
+ * Avec --append=F, les arêtes d'un calcul précédent (enregistrées avec
+ * --save-edges=F) sont reprises et seules les paires qui touchent une séquence
+ * ajoutée à la fin du FASTA sont calculées.
+ * Avec --epsilon=E1,E2,..., les distances sont calculées une seule fois avec le
+ * plus grand seuil, et un graphe DOT est écrit pour chaque seuil.
+ * Avec --ring, les séquences ne sont pas mises en commun : chaque rang garde
+ * celles qu'il a lues et les blocs des autres rangs circulent en anneau
+ * (voir RingExchange.hpp), pour des jeux trop gros pour la mémoire d'un nœud.
+ * Avec --dedup=F, les séquences identiques ne forment qu'un sommet, et la liste
+ * des copies de chaque sommet est écrite dans F pour PAM (voir Dedup.hpp).
+ *
  * @param argc Nombre d'arguments de la ligne de commande.
  * @param argv Tableau d'arguments (argv[1] doit être le fichier FASTA).
  *
  * @return 0 en cas de succès, une valeur non nulle si une erreur survient.
  */
 int main(int argc, char** argv) {
-    MPI_Init(&argc, &argv);
+    // Seul le thread principal appelle MPI (les threads de calcul ne font que
+    // des distances), donc MPI_THREAD_FUNNELED suffit.
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
 
     int rank, size;
     MPI_Comm_rank(MPI_COMM_WORLD, &rank);
     MPI_Comm_size(MPI_COMM_WORLD, &size);
 
+    BuildOptions opt;
+    try {
+        opt = parseOptions(argc, argv);
+    } catch (const std::exception& e) {
+        if (rank == 0) std::cerr << "Erreur : " << e.what() << "\n" << usage();
+        MPI_Finalize();
+        return 1;
+    }
+
      // Ici je récupère le fichier FASTA en argument.
     // C'est lui qui contient toutes les séquences 
-    const std::string fastaFile = argv[1];
+    const std::string& fastaFile = opt.fastaFile;
         // Et je fixe le nom du fichier DOT de sortie, que je vais donner ensuite à Floyd.
     const std::string dotFile   = "../../DATA/Resulat_sequence_by_premier_algo.dot";
 
    // Paramètre epsilon (voir énoncé, genre epsilon = 70).
     // Si la distance de Hamming entre deux séquences est < epsilon,
     // alors je crée une arête entre elles dans le graphe.    const int epsilon = 70;
-    const int epsilon = 70;
+    // Avec --epsilon=E1,E2,..., un seul calcul des distances avec le plus grand
+    // seuil, puis un graphe par seuil (les arêtes d'un seuil plus petit sont
+    // un sous-ensemble de celles du plus grand).
+    const std::vector<int> epsilons = opt.epsilons.empty() ? std::vector<int>{70} : opt.epsilons;
+    const int epsilon = epsilons.back();
 
     int n = 0;       // nombre de séquences
     int L = 0;       // longueur d'une séquence
      // Je vais stocker toutes les séquences à la suite dans un seul gros tableau de chars,
     // de taille n * L. La séquence i commence à l'offset i * L.
     std::vector<char> allSeqs;  // tableau contigu de taille n * L
+    std::vector<int> editLens;  // longueur de chaque séquence (distance d'édition, lecture rang 0)
+
+    const bool useEdit = (opt.distance == Distance::Edit);
+    const bool useHamming = (opt.distance == Distance::Hamming);
+    // La distance pondérée travaille toujours sur le codage 2 bits.
+    const bool useWeighted = (opt.distance == Distance::Weighted);
+    // Le moteur gemm garde les séquences codées sur 2 bits (échange, doublons,
+    // LSH) et ne fabrique le one-hot que par morceaux, au moment du calcul.
+    const bool useGemm = useHamming && (opt.kernel == Kernel::Gemm);
+    const bool usePacked = useWeighted || (useHamming && (opt.kernel == Kernel::Packed || useGemm));
+    PackedSeqs packed;
+    // Mode anneau : seulement les séquences lues par ce rang (indices globaux
+    // à partir de localFirst), packed ne sert qu'au calcul de chaque étape.
+    const bool useRing = opt.ring;
+    PackedSeqs localPacked;
+    int localFirst = 0;
+    EditSeqs editSeqs;
+    HammingKernel charKernel = {hammingScalar, hammingScalarBounded, "scalar"};
+    GemmKernel gemmKernel = {nullptr, 0, ""};
+    WeightedModel weightedModel;
+    WeightedKernel weightedKernel = {nullptr, ""};
+
+    if (useEdit) {
+        if (rank == 0) {
+            std::cout << "Distance d'edition bit-parallele (Myers / Hyyro), bornee par epsilon\n";
+        }
+    } else if (useWeighted) {
+        // Le noyau est choisi après la lecture, quand L est connu (poids par position)
+    } else if (useGemm) {
+        try {
+            gemmKernel = selectGemmKernel(opt.simd);
+        } catch (const std::exception& e) {
+            std::cerr << "Erreur (rang " << rank << ") : " << e.what() << "\n";
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (rank == 0) {
+            std::cout << "Hamming par produit de matrices one-hot, micro-noyau (rang 0) : "
+                      << gemmKernel.name << "\n";
+        }
+    } else if (!usePacked) {
+        // Chaque rang choisit son noyau d'après son propre processeur (CPUID) :
+        // les nœuds du cluster ne sont pas forcément de la même génération.
+        try {
+            charKernel = selectHammingKernel(opt.simd);
+        } catch (const std::exception& e) {
+            std::cerr << "Erreur (rang " << rank << ") : " << e.what() << "\n";
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (rank == 0) {
+            std::cout << "Noyau de Hamming (rang 0) : " << charKernel.name << "\n";
+        }
+    }
 
     // ----------------------------------------------------------
-    // Rang 0 : lecture du FASTA + contrôle des longueurs
+    // Lecture du FASTA et mise en commun des séquences
     // ----------------------------------------------------------
-                // Je fais toute la lecture disque uniquement sur le rang 0
+    MPI_Barrier(MPI_COMM_WORLD);
+    double tRead0 = MPI_Wtime();
 
-    if (rank == 0) {
+    if (opt.reader == Reader::Parallel) {
+        // Chaque rang lit sa propre tranche du fichier (mmap), puis on
+        // rassemble les séquences sur tout le monde : plus de lecteur unique.
+        FastaPart part;
         try {
-            // Je lis le FASTA et je récupère un vecteur de chaînes,
-            // chaque string correspond à une séquence.
-            std::vector<std::string> seqs = readFasta(fastaFile);
-            n = (int)seqs.size();
-            if (n == 0) {
-                throw std::runtime_error("Aucune sequence lue dans " + fastaFile);
+            part = readFastaPart(fastaFile, MPI_COMM_WORLD, !useEdit);
+        } catch (const std::exception& e) {
+            // L'erreur est la même sur tous les rangs, je l'affiche une seule fois
+            if (rank == 0) std::cerr << "Erreur : " << e.what() << "\n";
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        n = part.n;
+        L = part.L;
+        if (rank == 0) {
+            std::cout << "\n\nLecture FASTA: n = " << n
+                      << (useEdit ? ", longueur max L = " : ", longueur L = ") << L << "\n";
+        }
+
+        if (useEdit) {
+            // Longueurs différentes : on échange les longueurs puis les caractères
+            std::vector<int> lens;
+            try {
+                allSeqs = allgatherFastaVariable(part, lens, MPI_COMM_WORLD);
+            } catch (const std::exception& e) {
+                if (rank == 0) std::cerr << "Erreur : " << e.what() << "\n";
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            editSeqs = buildEditSeqs(std::move(allSeqs), lens);
+        } else if (usePacked) {
+            // Chaque rang code ses séquences, et on échange directement
+            // la version compacte (4 fois plus petite).
+            localPacked = packSequences(part.seqs.data(), part.count, L);
+            localFirst = part.first;
+            std::vector<char>().swap(part.seqs);
+            if (!useRing) {
+                packed = allgatherPackedSeqs(localPacked, MPI_COMM_WORLD);
+                localPacked = PackedSeqs();
             }
-                        // Je prends la longueur de la première séquence comme référence
-            L = (int)seqs[0].size();
-         
+        } else {
+            allSeqs = allgatherFasta(part, MPI_COMM_WORLD);
+        }
+    } else {
+        // ----------------------------------------------------------
+        // Rang 0 : lecture du FASTA + contrôle des longueurs
+        // ----------------------------------------------------------
+                    // Je fais toute la lecture disque uniquement sur le rang 0
 
-            std::cout << "\n\nLecture FASTA: n = " << n
-                      << ", longueur L = " << L << "\n";
-
-            // Copie dans un tableau contigu n * L
-              // Maintenant je recopie tout dans un grand tableau contigu n * L.
-            // Comme ça après, chaque processus peut calculer les distances
-            // juste avec un &allSeqs[i * L].
-            allSeqs.resize(n * L);
-            for (int i = 0; i < n; ++i) {
-                std::copy(seqs[i].begin(), seqs[i].end(),
-                          allSeqs.begin() + i * L);
+        if (rank == 0) {
+            try {
+                // Je lis le FASTA et je récupère un vecteur de chaînes,
+                // chaque string correspond à une séquence.
+                std::vector<std::string> seqs = readFasta(fastaFile);
+                n = (int)seqs.size();
+                if (n == 0) {
+                    throw std::runtime_error("Aucune sequence lue dans " + fastaFile);
+                }
+                            // Je prends la longueur de la première séquence comme référence
+                L = (int)seqs[0].size();
+                if (useEdit) {
+                    // En distance d'édition les longueurs peuvent différer :
+                    // je garde chaque longueur, et L devient la plus grande
+                    long long total = 0;
+                    editLens.resize(n);
+                    for (int i = 0; i < n; ++i) {
+                        editLens[i] = (int)seqs[i].size();
+                        total += editLens[i];
+                        L = std::max(L, editLens[i]);
+                    }
+                    if (total > INT_MAX) {
+                        throw std::runtime_error("Trop de caracteres pour MPI_Bcast ("
+                                                 + std::to_string(total) + ")");
+                    }
+                } else {
+                    // Sinon la distance de Hamming lirait hors des séquences plus courtes
+                    for (int i = 1; i < n; ++i) {
+                        if ((int)seqs[i].size() != L) {
+                            throw std::runtime_error("Les sequences n'ont pas toutes la meme longueur (sequence "
+                                                     + std::to_string(i) + " : "
+                                                     + std::to_string(seqs[i].size()) + " au lieu de "
+                                                     + std::to_string(L) + ")");
+                        }
+                    }
+                }
+
+                std::cout << "\n\nLecture FASTA: n = " << n
+                          << (useEdit ? ", longueur max L = " : ", longueur L = ") << L << "\n";
+
+                // Copie dans un tableau contigu n * L
+                  // Maintenant je recopie tout dans un grand tableau contigu n * L.
+                // Comme ça après, chaque processus peut calculer les distances
+                // juste avec un &allSeqs[i * L].
+                // (En distance d'édition, les séquences sont juste mises à la suite.)
+                for (int i = 0; i < n; ++i) {
+                    allSeqs.insert(allSeqs.end(), seqs[i].begin(), seqs[i].end());
+                }
+            } catch (const std::exception& e) {
+                // Si je tombe sur un problème (fichier introuvable, séquences pas de même taille, etc.),
+                // j'affiche l'erreur sur le rang 0 et j'arrête tout le monde proprement
+                std::cerr << "Erreur (rang 0) : " << e.what() << "\n";
+                MPI_Abort(MPI_COMM_WORLD, 1);
             }
-        } catch (const std::exception& e) {
-            // Si je tombe sur un problème (fichier introuvable, séquences pas de même taille, etc.),
-            // j'affiche l'erreur sur le rang 0 et j'arrête tout le monde proprement
-            std::cerr << "Erreur (rang 0) : " << e.what() << "\n";
-            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+
+        // ----------------------------------------------------------
+        // Diffuser n et L à tous les processus
+        // ----------------------------------------------------------
+          // Ici j’envoie à tout le monde le nombre de séquences (n)
+        // et la longueur d’une séquence (L), que seul le rang 0 connaît au début.
+        MPI_Bcast(&n, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        MPI_Bcast(&L, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+        if (useEdit) {
+            // Les longueurs d'abord, puis toutes les séquences à la suite
+            editLens.resize(n);
+            MPI_Bcast(editLens.data(), n, MPI_INT, 0, MPI_COMM_WORLD);
+            long long total = 0;
+            for (int len : editLens) total += len;
+            allSeqs.resize((size_t)total);
+            MPI_Bcast(allSeqs.data(), (int)total, MPI_CHAR, 0, MPI_COMM_WORLD);
+            editSeqs = buildEditSeqs(std::move(allSeqs), editLens);
+        } else if (usePacked) {
+            // Version compacte : le rang 0 code les séquences sur 2 bits par base,
+            // et on diffuse ce tableau 4 fois plus petit à la place de allSeqs.
+            if (rank == 0) {
+                packed = packSequences(allSeqs.data(), n, L);
+                std::vector<char>().swap(allSeqs);  // plus besoin du tableau brut
+            }
+            bcastPackedSeqs(packed, 0, MPI_COMM_WORLD);
+        } else {
+            // Tous les rangs allouent le tableau allSeqs,
+            // sauf le rang 0 qui l’a déjà rempli plus haut.
+            if (rank != 0) {
+                allSeqs.resize(n * L);
+            }
+
+            // Ici je diffuse toutes les séquences en une seule fois :
+            // le rang 0 envoie son gros tableau n*L vers tout le monde.
+            MPI_Bcast(allSeqs.data(), n * L, MPI_CHAR, 0, MPI_COMM_WORLD);
         }
     }
 
+    MPI_Barrier(MPI_COMM_WORLD);
+    double tRead1 = MPI_Wtime();
+    if (rank == 0) {
+        std::cout << ">>> Temps lecture + mise en commun des sequences = "
+                  << (tRead1 - tRead0) * 1000 << " millisecondes\n";
+    }
+
     // ----------------------------------------------------------
-    // Diffuser n et L à tous les processus
+    // --dedup : un seul sommet par séquence distincte
     // ----------------------------------------------------------
-      // Ici j’envoie à tout le monde le nombre de séquences (n)
-    // et la longueur d’une séquence (L), que seul le rang 0 connaît au début.
-    MPI_Bcast(&n, 1, MPI_INT, 0, MPI_COMM_WORLD);
-    MPI_Bcast(&L, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    // Chaque rang a toutes les séquences et fait le même regroupement, sans
+    // communication. Deux séquences sont regroupées quand leur distance est
+    // nulle pour la distance choisie (T = U avec le codage 2 bits et en édition).
+    const bool useDedup = !opt.dedupFile.empty();
+    SeqGroups groups;
+    if (useDedup) {
+        if (useEdit) {
+            groups = groupDuplicates(n,
+                [&](int i) {
+                    std::string s(&editSeqs.chars[editSeqs.start[i]], editSeqs.length(i));
+                    std::replace(s.begin(), s.end(), 'U', 'T');
+                    return hashBytes(s.data(), s.size());
+                },
+                [&](int a, int b) { return editDistanceBounded(editSeqs, a, b, 1) == 0; });
+
+            std::vector<char> chars;
+            std::vector<int> lens;
+            for (int i : groups.rep) {
+                chars.insert(chars.end(), &editSeqs.chars[editSeqs.start[i]],
+                             &editSeqs.chars[editSeqs.start[i]] + editSeqs.length(i));
+                lens.push_back(editSeqs.length(i));
+            }
+            editSeqs = buildEditSeqs(std::move(chars), lens);
+        } else if (usePacked) {
+            // Hachage directement sur les mots codés (et les exceptions)
+            groups = groupDuplicates(n,
+                [&](int i) {
+                    uint64_t h = hashBytes(&packed.codes[(size_t)i * packed.words],
+                                           packed.words * sizeof(uint64_t));
+                    const int e0 = packed.excOffset[i], e1 = packed.excOffset[i + 1];
+                    h = hashBytes(packed.excPos.data() + e0, (e1 - e0) * sizeof(int), h);
+                    return hashBytes(packed.excChar.data() + e0, e1 - e0, h);
+                },
+                [&](int a, int b) { return hammingPacked(packed, a, b) == 0; });
+            packed = selectPacked(packed, groups.rep);
+        } else {
+            groups = groupDuplicates(n,
+                [&](int i) { return hashBytes(&allSeqs[(size_t)i * L], L); },
+                [&](int a, int b) {
+                    return std::equal(&allSeqs[(size_t)a * L], &allSeqs[(size_t)a * L] + L,
+                                      &allSeqs[(size_t)b * L]);
+                });
+            std::vector<char> kept((size_t)groups.rep.size() * L);
+            for (size_t u = 0; u < groups.rep.size(); ++u) {
+                std::copy(&allSeqs[(size_t)groups.rep[u] * L], &allSeqs[(size_t)groups.rep[u] * L] + L,
+                          &kept[u * L]);
+            }
+            allSeqs.swap(kept);
+        }
+
+        if (rank == 0) {
+            std::cout << "Doublons regroupes : " << n << " sequences -> "
+                      << groups.rep.size() << " sommets\n";
+        }
+        n = (int)groups.rep.size();
+    }
 
+    // ----------------------------------------------------------
+    // Distance pondérée : coûts des substitutions et poids des positions
+    // ----------------------------------------------------------
+    // Le rang 0 lit le fichier de poids et le diffuse ; chaque rang prépare
+    // ensuite le même modèle et choisit son noyau d'après son processeur.
+    if (useWeighted) {
+        std::vector<int> positionWeights;
+        int nWeights = 0;
+        if (rank == 0 && !opt.positionWeightsFile.empty()) {
+            try {
+                positionWeights = readPositionWeights(opt.positionWeightsFile);
+            } catch (const std::exception& e) {
+                std::cerr << "Erreur (rang 0) : " << e.what() << "\n";
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+            nWeights = (int)positionWeights.size();
+        }
+        MPI_Bcast(&nWeights, 1, MPI_INT, 0, MPI_COMM_WORLD);
+        positionWeights.resize(nWeights);
+        MPI_Bcast(positionWeights.data(), nWeights, MPI_INT, 0, MPI_COMM_WORLD);
+        if (!opt.positionWeightsFile.empty() && nWeights == 0) {
+            if (rank == 0) std::cerr << "Erreur : aucun poids dans " << opt.positionWeightsFile << "\n";
+            MPI_Finalize();
+            return 1;
+        }
 
+        try {
+            weightedModel = makeWeightedModel(opt.transitionCost, opt.transversionCost,
+                                              positionWeights, L);
+            weightedKernel = selectWeightedKernel(weightedModel, opt.simd);
+        } catch (const std::exception& e) {
+            std::cerr << "Erreur (rang " << rank << ") : " << e.what() << "\n";
+            MPI_Abort(MPI_COMM_WORLD, 1);
+        }
+        if (rank == 0) {
+            std::cout << "Distance ponderee : transition = " << weightedModel.transition
+                      << ", transversion = " << weightedModel.transversion
+                      << (weightedModel.uniform ? ", poids 1 partout" : ", poids par position")
+                      << ", noyau (rang 0) : " << weightedKernel.name << "\n";
+        }
+    }
 
-    // Tous les rangs allouent le tableau allSeqs,
-    // sauf le rang 0 qui l’a déjà rempli plus haut.
-    if (rank != 0) {
-        allSeqs.resize(n * L);
+    // Le tirage des bandes LSH prend des positions distinctes dans [0, L)
+    const bool useLsh = (opt.lshBands > 0);
+    if (useLsh && opt.lshRows > L) {
+        if (rank == 0) {
+            std::cerr << "Erreur : --lsh demande " << opt.lshRows << " positions par bande, "
+                      << "mais les sequences n'ont que " << L << " bases\n";
+        }
+        MPI_Finalize();
+        return 1;
     }
 
-    // Ici je diffuse toutes les séquences en une seule fois :
-    // le rang 0 envoie son gros tableau n*L vers tout le monde.
-    MPI_Bcast(allSeqs.data(), n * L, MPI_CHAR, 0, MPI_COMM_WORLD);
+    // ----------------------------------------------------------
+    // Mode ajout : reprise des arêtes d'un calcul précédent
+    // ----------------------------------------------------------
+    const int distanceId = useEdit ? 1 : (useWeighted ? 2 : 0);
+    const uint32_t modelId = useWeighted ? weightedModel.fingerprint : 0;
+
+    // Empreinte des count premières séquences, pour vérifier qu'un fichier
+    // d'arêtes correspond bien au début du FASTA (U compté comme T, comme
+    // dans le codage 2 bits, pour que l'empreinte ne dépende pas du noyau).
+    auto fingerprint = [&](int count) -> uint64_t {
+        uint64_t h = 0xcbf29ce484222325ULL;   // FNV-1a
+        auto mix = [&h](uint64_t v) {
+            h ^= v;
+            h *= 0x100000001b3ULL;
+        };
+        for (int i = 0; i < count; ++i) {
+            const int len = useEdit ? editSeqs.length(i) : L;
+            mix((uint64_t)len);
+            for (int p = 0; p < len; ++p) {
+                char c = useEdit    ? editSeqs.chars[editSeqs.start[i] + p]
+                       : usePacked  ? baseAt(packed, i, p)
+                                    : allSeqs[(size_t)i * L + p];
+                mix((unsigned char)(c == 'U' ? 'T' : c));
+            }
+        }
+        return h;
+    };
+
+    std::vector<Edge> oldEdges;   // arêtes reprises (rang 0 seulement)
+    int firstNew = 0;             // seules les paires (i, j) avec j >= firstNew sont calculées
+    if (!opt.appendFile.empty()) {
+        if (rank == 0) {
+            try {
+                EdgeFileHeader old;
+                oldEdges = loadEdges(opt.appendFile, old);
+                if (old.distance != distanceId || old.model != modelId) {
+                    throw std::runtime_error(opt.appendFile + " a ete calcule avec une autre distance"
+                                             " (ou d'autres couts / poids)");
+                }
+                if (old.epsilon < epsilon) {
+                    throw std::runtime_error(opt.appendFile + " a ete calcule avec epsilon = "
+                                             + std::to_string(old.epsilon) + ", il manque les aretes jusqu'a "
+                                             + std::to_string(epsilon));
+                }
+                // Seuil enregistré plus grand : on ne garde que les arêtes utiles
+                oldEdges.erase(std::remove_if(oldEdges.begin(), oldEdges.end(),
+                                              [epsilon](const Edge& e) { return e.d >= epsilon; }),
+                               oldEdges.end());
+                if (old.n > n) {
+                    throw std::runtime_error(opt.appendFile + " contient " + std::to_string(old.n)
+                                             + " sequences, mais le FASTA seulement " + std::to_string(n));
+                }
+                if (old.fingerprint != fingerprint(old.n)) {
+                    throw std::runtime_error("les " + std::to_string(old.n) + " premieres sequences du FASTA "
+                                             "ne sont pas celles de " + opt.appendFile);
+                }
+                firstNew = old.n;
+                std::cout << "Ajout : " << firstNew << " sequences deja calculees ("
+                          << oldEdges.size() << " aretes), " << (n - firstNew) << " nouvelles\n";
+            } catch (const std::exception& e) {
+                std::cerr << "Erreur (rang 0) : " << e.what() << "\n";
+                MPI_Abort(MPI_COMM_WORLD, 1);
+            }
+        }
+        MPI_Bcast(&firstNew, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    }
 
     // ----------------------------------------------------------
     // Mesure du temps MPI (calcul + rassemblement)
@@ -261,98 +576,400 @@ int main(int argc, char** argv) {
     double t0 = MPI_Wtime();
 
     // ----------------------------------------------------------
-    // Chaque rang calcule un sous-ensemble de lignes de la matrice
+    // Chaque rang calcule une tranche du triangle supérieur (i < j)
     // ----------------------------------------------------------
-        // Je découpe les n séquences en "tranches" entre les processus.
-    // chunk = nombre de lignes (séquences) par processus, en arrondissant vers le haut.
-    int chunk = (n + size - 1) / size;  // ceil(n / size)
-    int start = rank * chunk; // première ligne (incluse) pour ce rang
-    int end   = std::min(n, start + chunk);  // dernière ligne (exclue) pour ce rang on fait ça pour éviter de dépasser n
-
-     // Nombre de lignes réellement calculées par ce rang
-    int localRows = std::max(0, end - start);
+    // La matrice est symétrique avec des 0 sur la diagonale : seules les
+    // n(n-1)/2 paires i < j sont utiles. Je découpe ce triangle en tuiles
+    // de T × T paires (voir Tiles.hpp) pour que les séquences d'une tuile
+    // restent dans le cache. Par défaut, les rangs prennent les tuiles par
+    // paquets dans un compteur partagé (voir TileScheduler.hpp) : un rang plus
+    // lent en fait simplement moins. Avec --schedule=static, chaque rang reçoit
+    // d'avance une suite de tuiles contenant le même nombre de paires.
+    //
+    // Dans un rang, les tuiles sont partagées entre nThreads threads qui lisent
+    // tous la même copie des séquences (un seul rang par nœud suffit donc, au
+    // lieu d'une copie par cœur). Chaque thread vole des tuiles aux autres
+    // quand il a fini les siennes (voir WorkStealing.hpp).
+    int nThreads = opt.threads;
+    if (nThreads == 0) {
+        nThreads = std::max(1, (int)std::thread::hardware_concurrency());
+    }
+    // Sans MPI_THREAD_FUNNELED, MPI ne supporte pas d'autres threads dans le
+    // processus : on reste sur le thread principal.
+    if (provided < MPI_THREAD_FUNNELED && nThreads > 1) {
+        if (rank == 0)
+            std::cout << "[WARN] MPI_THREAD_FUNNELED non fourni par MPI : --threads ignore (1 thread par rang)\n";
+        nThreads = 1;
+    }
 
+    // Distance entre les séquences a et b avec le noyau choisi. En mode borné,
+    // le calcul s'arrête dès que la distance atteint epsilon (elle vaut alors
+    // epsilon) : ces paires ne donnent de toute façon pas d'arête.
+    // La distance d'édition est toujours bornée (bande de largeur epsilon).
+    auto distance = [&](int a, int b) -> int {
+        if (useEdit) {
+            return editDistanceBounded(editSeqs, a, b, epsilon);
+        }
+        if (useWeighted) {
+            return weightedKernel.fn(weightedModel, packed, a, b, opt.bounded ? epsilon : INT_MAX);
+        }
+        if (usePacked) {
+            return opt.bounded ? hammingPackedBounded(packed, a, b, epsilon)
+                               : hammingPacked(packed, a, b);
+        }
+        const char* sa = &allSeqs[(size_t)a * L];
+        const char* sb = &allSeqs[(size_t)b * L];
+        return opt.bounded ? charKernel.bounded(sa, sb, L, epsilon)
+                           : charKernel.fn(sa, sb, L);
+    };
+
+    // Je ne garde que les paires qui deviendront des arêtes (d < epsilon) :
+    // pas besoin de stocker ni d'envoyer les autres distances.
+    // Chaque thread remplit sa propre liste, fusionnée après le calcul.
+    auto tileEdges = [&](const Tile& tile, std::vector<Edge>& out) {
+        if (useGemm) {
+            // Toute la tuile d'un coup, puis lecture des distances
+            thread_local std::vector<int> tileDist;
+            gemmTileDistances(packed, tile, gemmKernel, tileDist);
+            const int cols = tile.j1 - tile.j0;
+            forEachPair(tile, [&](int i, int j) {
+                int d = tileDist[(size_t)(i - tile.i0) * cols + (j - tile.j0)];
+                if (d < epsilon) {
+                    out.push_back({i, j, d});
+                }
+            });
+            return;
+        }
+        forEachPair(tile, [&](int i, int j) {
+            int d = distance(i, j);
+            if (d < epsilon) {
+                out.push_back({i, j, d});
+            }
+        });
+    };
+
+    size_t bytesPerSeq = usePacked ? (size_t)std::max(packed.words, localPacked.words) * sizeof(uint64_t)
+                                   : (size_t)L;
+    if (useEdit) {
+        // Caractères + masques des blocs de 64 bases, en moyenne par séquence
+        bytesPerSeq = (editSeqs.chars.size() + editSeqs.peq.size() * sizeof(uint64_t))
+                      / std::max(1, n);
+    } else if (useGemm) {
+        // Un morceau de one-hot par séquence (4 octets par base)
+        bytesPerSeq = (size_t)4 * std::min(L, GEMM_KC_BASES);
+    }
 
-    
-    // Chaque rang va calculer localRows lignes de la matrice des distances,
-    // donc au total localRows * n entiers. 
-    std::vector<int> localDist(localRows * n);
+    auto computeAllPairs = [&](std::vector<std::vector<Edge>>& threadEdges) {
+        const int T = (opt.tile > 0) ? std::min(opt.tile, std::max(1, n))
+                                     : autoTileSize(bytesPerSeq, n, size * nThreads);
+        const bool dynamic = (opt.schedule == Schedule::Dynamic);
+        if (rank == 0) {
+            std::cout << "Taille des tuiles : " << T << " x " << T << " sequences, "
+                      << nThreads << " thread(s) par processus, repartition "
+                      << (dynamic ? "dynamique" : "statique") << "\n";
+        }
 
-    for (int i = start; i < end; ++i) {
-          // seq_i = séquence de la ligne i
-        const char* seq_i = &allSeqs[i * L];
-                // rowOffset = où commence la ligne i dans le tableau localDist
+        std::vector<Tile> tiles = upperTriangleTiles(n, T, firstNew);
+        auto computeTile = [&](int w, size_t t) { tileEdges(tiles[t], threadEdges[w]); };
 
-        int rowOffset = (i - start) * n;
+        if (!dynamic) {
+            size_t tBegin, tEnd;
+            tileRange(tiles, rank, size, tBegin, tEnd);
+            parallelForStealing(tBegin, tEnd, nThreads, computeTile);
+            return;
+        }
 
-        for (int j = 0; j < n; ++j) {
-            const char* seq_j = &allSeqs[j * L];
-              // Distance de Hamming entre i et j.
-            // Par convention je mets 0 sur la diagonale (i == j).
-            int d = (i == j) ? 0 : hamming(seq_i, seq_j, L);
-            localDist[rowOffset + j] = d;
+        // Le thread principal tire un paquet (seul lui appelle MPI), puis les
+        // threads du rang se le partagent avant le tirage suivant. Entre deux
+        // tuiles, il fait avancer les tirages des autres rangs (rang 0).
+        TileScheduler scheduler(tiles.size(), nThreads, MPI_COMM_WORLD);
+        size_t tBegin, tEnd;
+        while (scheduler.next(tBegin, tEnd)) {
+            parallelForStealing(tBegin, tEnd, nThreads, [&](int w, size_t t) {
+                computeTile(w, t);
+                if (w == 0) scheduler.progress();
+            });
+        }
+    };
+
+    // Mode anneau : à chaque étape, packed contient mon bloc suivi du bloc
+    // reçu (voir RingExchange.hpp), et les arêtes trouvées sont remises en
+    // indices globaux. Le bloc suivant arrive pendant le calcul.
+    auto computeRing = [&](std::vector<std::vector<Edge>>& threadEdges) {
+        const RingLayout layout = ringLayout(localPacked, localFirst, MPI_COMM_WORLD);
+        const int maxBlock = *std::max_element(layout.count.begin(), layout.count.end());
+        const int T = (opt.tile > 0) ? std::min(opt.tile, std::max(1, maxBlock))
+                                     : autoTileSize(bytesPerSeq, maxBlock, nThreads);
+        const int steps = size / 2;
+        if (rank == 0) {
+            std::cout << "Anneau : " << steps + 1 << " etape(s), au plus " << maxBlock
+                      << " sequences par bloc, tuiles de " << T << " x " << T << ", "
+                      << nThreads << " thread(s) par processus\n";
         }
-    }
 
-    // ----------------------------------------------------------
-    // Rassemblement de la matrice des distances sur le rang 0
-    // ----------------------------------------------------------
-    std::vector<int> fullDist;
-    if (rank == 0) {
-                // Rang 0 alloue la matrice complète n*n.
+        const int nLocal = localPacked.n;
+        RingShift shift(localPacked.words, MPI_COMM_WORLD);
+        PackedSeqs visiting, incoming;
 
-        fullDist.resize(n * n);
-    }
-    // Je repasse sur tous les rangs r pour reconstruire la matrice globale
-    // dans le bon ordre des lignes.
-    for (int r = 0; r < size; ++r) {
-        int r_start = r * chunk;
-        int r_end   = std::min(n, r_start + chunk);
-        int r_rows  = std::max(0, r_end - r_start);
-        int count   = r_rows * n;
+        for (int s = 0; s <= steps; ++s) {
+            if (s < steps) {
+                const int nextBlock = (rank - s - 1 + 2 * size) % size;
+                shift.start(s == 0 ? localPacked : visiting, incoming, nextBlock, layout);
+            }
 
-        if (r_rows == 0) continue; // ce rang n'a pas de lignes
+            const int q = (rank - s + size) % size;   // bloc vu à cette étape
+            std::vector<Tile> tiles;
+            if (s == 0) {
+                packed = localPacked;
+                tiles = upperTriangleTiles(nLocal, T);
+            } else {
+                packed = concatPacked(localPacked, visiting);
+                // p pair, dernière étape : les rangs r et q voient la même paire
+                // de blocs. Le bloc du plus petit des deux est coupé en deux :
+                // sa première moitié est calculée par lui, la seconde par l'autre.
+                int r1 = nLocal, c0 = nLocal;
+                if (2 * s == size) {
+                    if (rank < q) r1 = nLocal / 2;
+                    else          c0 = nLocal + visiting.n / 2;
+                }
+                tiles = rectangleTiles(0, r1, c0, packed.n, T);
+            }
 
-        if (rank == 0) {
-            // Côté rang 0 : je récupère ce que le rang r a calculé.
-            if (r == 0) {
-                 // Pour r == 0, je copie directement mon propre localDist
-                // au bon endroit dans fullDist.
+            std::vector<size_t> before(nThreads);
+            for (int w = 0; w < nThreads; ++w) before[w] = threadEdges[w].size();
+            // Le thread principal (worker 0) fait avancer le décalage en cours
+            // entre deux tuiles, sinon le bloc suivant n'arrive qu'au wait()
+            parallelForStealing(0, tiles.size(), nThreads, [&](int w, size_t t) {
+                tileEdges(tiles[t], threadEdges[w]);
+                if (w == 0 && s < steps) shift.test();
+            });
+
+            // Indices globaux, avec i < j comme dans le reste du programme
+            for (int w = 0; w < nThreads; ++w) {
+                for (size_t k = before[w]; k < threadEdges[w].size(); ++k) {
+                    Edge& e = threadEdges[w][k];
+                    e.i += localFirst;
+                    e.j = (e.j < nLocal) ? localFirst + e.j : layout.first[q] + (e.j - nLocal);
+                    if (e.i > e.j) std::swap(e.i, e.j);
+                }
+            }
 
-                std::copy(localDist.begin(), localDist.end(),
-                          fullDist.begin() + r_start * n);
-            } else {
-                // Recevoir le bloc du rang r
- // Pour les autres rangs, je reçois leurs lignes dans un buffer,
-                // puis je copie ça dans la zone correspondant à r_start, r_end.
-
-                std::vector<int> buf(count);
-                MPI_Recv(buf.data(), count, MPI_INT, r, 0,
-                         MPI_COMM_WORLD, MPI_STATUS_IGNORE);
-                std::copy(buf.begin(), buf.end(),
-                          fullDist.begin() + r_start * n);
+            if (s < steps) {
+                shift.wait();
+                std::swap(visiting, incoming);
             }
-        } else if (rank == r) {
-            // Rang r (/= 0) : envoie son bloc local au rang 0
-            MPI_Send(localDist.data(), count, MPI_INT, 0, 0, MPI_COMM_WORLD);
+        }
+        packed = PackedSeqs();
+    };
+
+    std::vector<std::vector<Edge>> threadEdges(nThreads);
+    long long candidates = 0;   // paires vérifiées par ce rang (mode LSH)
+
+    if (useLsh) {
+        // ----------------------------------------------------------
+        // Filtre LSH : seules les paires qui partagent un seau sont vérifiées
+        // ----------------------------------------------------------
+        // Chaque rang calcule toutes les signatures sur sa copie des séquences
+        // (n * B * R bases lues, négligeable devant les distances) : les seaux
+        // sont donc les mêmes partout sans communication.
+        const uint64_t LSH_SEED = 20240601;
+        std::vector<int> positions = lshPositions(L, opt.lshBands, opt.lshRows, LSH_SEED);
+        std::vector<uint64_t> sig = usePacked
+            ? lshSignatures(n, positions, opt.lshBands, opt.lshRows,
+                            [&](int i, int p) { return baseAt(packed, i, p); })
+            : lshSignatures(n, positions, opt.lshBands, opt.lshRows,
+                            [&](int i, int p) { return allSeqs[(size_t)i * L + p]; });
+        LshCandidates cand = buildLshCandidates(std::move(sig), n, opt.lshBands);
+
+        // Les lignes des seaux sont distribuées en tourniquet : dans un gros
+        // seau, les lignes longues (début du seau) sont ainsi réparties entre
+        // tous les rangs.
+        std::vector<size_t> myRows;
+        for (size_t r = rank; r < cand.rows.size(); r += size) myRows.push_back(r);
+
+        std::vector<long long> threadPairs(nThreads, 0);
+        parallelForStealing(0, myRows.size(), nThreads, [&](int w, size_t t) {
+            std::vector<Edge>& out = threadEdges[w];
+            forEachCandidate(cand, cand.rows[myRows[t]], [&](int i, int j) {
+                if (j < firstNew) return;   // paire déjà calculée (mode ajout)
+                ++threadPairs[w];
+                int d = distance(i, j);
+                if (d < epsilon) {
+                    out.push_back({i, j, d});
+                }
+            });
+        });
+        for (long long c : threadPairs) candidates += c;
+    } else if (useRing) {
+        computeRing(threadEdges);
+    } else {
+        computeAllPairs(threadEdges);
+    }
+
+    std::vector<Edge> localEdges;
+    if (nThreads == 1) {
+        localEdges.swap(threadEdges[0]);
+    } else {
+        size_t nLocal = 0;
+        for (const std::vector<Edge>& e : threadEdges) nLocal += e.size();
+        localEdges.reserve(nLocal);
+        for (const std::vector<Edge>& e : threadEdges) {
+            localEdges.insert(localEdges.end(), e.begin(), e.end());
         }
     }
 
+    // ----------------------------------------------------------
+    // Rassemblement des arêtes sur le rang 0
+    // ----------------------------------------------------------
+    // Les tuiles mélangent les lignes, donc je retrie les arêtes par (i, j)
+    // pour que le fichier DOT ne dépende pas du découpage.
+    // En mode ajout, les anciennes arêtes sont remises avec les nouvelles.
+    std::vector<Edge> edges = gatherEdges(localEdges, 0, MPI_COMM_WORLD);
+    // Arêtes calculées par cette exécution (sans les anciennes) : c'est ce
+    // qui se compare au calcul exact de --lsh-check, fait sur les mêmes paires.
+    const long long newEdges = (long long)edges.size();
+    if (rank == 0) {
+        edges.insert(edges.end(), oldEdges.begin(), oldEdges.end());
+        std::vector<Edge>().swap(oldEdges);
+        sortEdges(edges);
+    }
+
     MPI_Barrier(MPI_COMM_WORLD);
     double t1 = MPI_Wtime();
 
     // ----------------------------------------------------------
-    // Rang 0 : écriture du fichier .dot + affichage du temps
+    // Mode LSH : nombre de paires vérifiées, et rappel si demandé
+    // ----------------------------------------------------------
+    long long totalCandidates = 0;
+    long long exactEdges = 0;
+    if (useLsh) {
+        MPI_Reduce(&candidates, &totalCandidates, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        if (opt.lshCheck) {
+            // Calcul exact de référence (hors chronomètre) : je ne garde que
+            // le nombre d'arêtes, les arêtes du LSH en sont un sous-ensemble.
+            std::vector<std::vector<Edge>> exact(nThreads);
+            computeAllPairs(exact);
+            long long nExact = 0;
+            for (const std::vector<Edge>& e : exact) nExact += (long long)e.size();
+            MPI_Reduce(&nExact, &exactEdges, 1, MPI_LONG_LONG, MPI_SUM, 0, MPI_COMM_WORLD);
+        }
+    }
+
+    // ----------------------------------------------------------
+    // Rang 0 : affichage du temps
     // ----------------------------------------------------------
     if (rank == 0) {
         std::cout << "\n\n>>> Temps total calcul distances + rassemblement = "
                   << (t1 - t0) * 1000 << " millisecondes\n\n";
 
+        if (useLsh) {
+            const long long allPairs = (long long)n * (n - 1) / 2
+                                     - (long long)firstNew * (firstNew - 1) / 2;
+            std::cout << "LSH (" << opt.lshBands << " bandes x " << opt.lshRows
+                      << " positions) : " << totalCandidates << " paires verifiees sur "
+                      << allPairs << " (" << 100.0 * totalCandidates / std::max(1LL, allPairs)
+                      << " %)\n";
+            if (opt.lshCheck) {
+                std::cout << "Rappel du LSH : " << newEdges << " aretes sur "
+                          << exactEdges << " en calcul exact ("
+                          << 100.0 * newEdges / std::max(1LL, exactEdges) << " %)\n";
+            }
+        }
+
+    }
+
+    // ----------------------------------------------------------
+    // Écriture des graphes (.dot, et CSR avec --csr)
+    // ----------------------------------------------------------
+    // Le CSR est écrit par le rang 0, qui a toutes les arêtes : il est bien
+    // plus petit que le .dot (environ 5 octets par arête et par sens).
+    // Par défaut le rang 0 renvoie à chaque rang une tranche consécutive des
+    // arêtes triées, et tous écrivent leur morceau du fichier en même temps
+    // (voir DotWriter.hpp). Avec --writer=rank0, le rang 0 écrit tout.
+    const bool parallelWriter = (opt.writer == Writer::Parallel);
+    const std::string distanceName = useEdit ? "distance d'edition"
+                                   : (useWeighted ? "distance ponderee" : "distance de Hamming");
+    std::vector<Edge> myEdges;
+    if (parallelWriter && opt.writeDot) {
+        myEdges = scatterEdges(edges, 0, MPI_COMM_WORLD);
+    }
+
+    auto fileForEpsilon = [&](const std::string& base, int eps) {
+        if (epsilons.size() == 1) return base;
+        size_t dot = base.find_last_of('.');
+        size_t slash = base.find_last_of('/');
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) dot = base.size();
+        return base.substr(0, dot) + "_eps" + std::to_string(eps) + base.substr(dot);
+    };
+
+    double tWrite0 = MPI_Wtime();
+    // Un graphe par seuil. Avec un seul seuil, le nom reste celui attendu
+    // par Floyd ; sinon le seuil est ajouté au nom (..._eps50.dot, ..._eps50.csr).
+    for (int eps : epsilons) {
+        if (!opt.csrFile.empty() && rank == 0) {
+            const std::string csr = fileForEpsilon(opt.csrFile, eps);
+            try {
+                writeCsrGraph(csr, edges, eps, n);
+                std::cout << "Graphe CSR ecrit dans " << csr << "\n";
+            } catch (const std::exception& e) {
+                std::cerr << "Erreur d'ecriture du graphe CSR : " << e.what() << "\n";
+            }
+        }
+
+        const std::string file = fileForEpsilon(dotFile, eps);
+        if (!opt.writeDot || (!parallelWriter && rank != 0)) continue;
         try {
-            writeDotGraph(dotFile, fullDist, n, epsilon);
-            std::cout << "Graphe .dot ecrit dans " << dotFile << "\n";
+            writeDotGraph(file, parallelWriter ? myEdges : edges, eps, n, distanceName,
+                          useDedup ? &groups : nullptr,
+                          parallelWriter ? MPI_COMM_WORLD : MPI_COMM_SELF);
+            if (rank == 0) std::cout << "Graphe .dot ecrit dans " << file << "\n";
         } catch (const std::exception& e) {
-            std::cerr << "Erreur d'ecriture du fichier .dot : " << e.what() << "\n";
+            if (rank == 0) std::cerr << "Erreur d'ecriture du fichier .dot : " << e.what() << "\n";
+        }
+    }
+    std::vector<Edge>().swap(myEdges);
+    MPI_Barrier(MPI_COMM_WORLD);
+    if (rank == 0) {
+        std::cout << ">>> Temps ecriture des graphes = " << (MPI_Wtime() - tWrite0) * 1000
+                  << " millisecondes\n";
+    }
+
+    // ----------------------------------------------------------
+    // Rang 0 : autres fichiers de sortie
+    // ----------------------------------------------------------
+    if (rank == 0) {
+        if (!opt.taggedEdgesFile.empty()) {
+            try {
+                writeTaggedEdges(opt.taggedEdgesFile, epsilons, edges);
+                std::cout << "Aretes avec leur plus petit seuil ecrites dans "
+                          << opt.taggedEdgesFile << "\n";
+            } catch (const std::exception& e) {
+                std::cerr << "Erreur d'ecriture du fichier d'aretes : " << e.what() << "\n";
+            }
+        }
+
+        if (useDedup) {
+            try {
+                writeGroups(opt.dedupFile, groups);
+                std::cout << "Groupes de sequences ecrits dans " << opt.dedupFile << "\n";
+            } catch (const std::exception& e) {
+                std::cerr << "Erreur d'ecriture du fichier de groupes : " << e.what() << "\n";
+            }
+        }
+
+        if (!opt.saveEdgesFile.empty()) {
+            try {
+                EdgeFileHeader header;
+                header.n = n;
+                header.epsilon = epsilon;
+                header.distance = distanceId;
+                header.model = modelId;
+                header.fingerprint = fingerprint(n);
+                saveEdges(opt.saveEdgesFile, header, edges);
+                std::cout << "Aretes enregistrees dans " << opt.saveEdgesFile << "\n";
+            } catch (const std::exception& e) {
+                std::cerr << "Erreur d'ecriture du fichier d'aretes : " << e.what() << "\n";
+            }
         }
     }
 
@@ -0,0 +1,72 @@
+#define OMPI_SKIP_MPICXX 1
+#include "CsrGraph.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+#include <stdexcept>
+
+static const char CSR_MAGIC[8] = {'G', 'R', 'A', 'P', 'H', 'C', 'S', 'R'};
+
+// Poids de 1, 2 ou 4 octets, selon la plus grande distance
+template <typename W>
+static std::vector<char> packWeights(const std::vector<int>& w) {
+    std::vector<char> out(w.size() * sizeof(W));
+    W* dst = (W*)out.data();
+    for (size_t k = 0; k < w.size(); ++k) dst[k] = (W)w[k];
+    return out;
+}
+
+void writeCsrGraph(const std::string& filename, const std::vector<Edge>& edges,
+                   int epsilon, int n)
+{
+    // Degré de chaque sommet, puis début de chaque ligne
+    std::vector<uint64_t> rowStart(n + 1, 0);
+    int maxWeight = 0;
+    for (const Edge& e : edges) {
+        if (e.d >= epsilon) continue;
+        ++rowStart[e.i + 1];
+        ++rowStart[e.j + 1];
+        maxWeight = std::max(maxWeight, e.d);
+    }
+    for (int i = 0; i < n; ++i) rowStart[i + 1] += rowStart[i];
+    const uint64_t nnz = rowStart[n];
+
+    // Voisins de chaque ligne, triés par colonne
+    std::vector<uint64_t> fill(rowStart.begin(), rowStart.end() - 1);
+    std::vector<std::pair<int, int>> entries(nnz);   // (colonne, poids)
+    for (const Edge& e : edges) {
+        if (e.d >= epsilon) continue;
+        entries[fill[e.i]++] = {e.j, e.d};
+        entries[fill[e.j]++] = {e.i, e.d};
+    }
+    std::vector<int32_t> col(nnz);
+    std::vector<int> weight(nnz);
+    for (int i = 0; i < n; ++i) {
+        std::sort(entries.begin() + rowStart[i], entries.begin() + rowStart[i + 1]);
+        for (uint64_t k = rowStart[i]; k < rowStart[i + 1]; ++k) {
+            col[k] = entries[k].first;
+            weight[k] = entries[k].second;
+        }
+    }
+    std::vector<std::pair<int, int>>().swap(entries);
+
+    const int weightBytes = (maxWeight < 256) ? 1 : (maxWeight < 65536) ? 2 : 4;
+    std::vector<char> packed = (weightBytes == 1) ? packWeights<uint8_t>(weight)
+                             : (weightBytes == 2) ? packWeights<uint16_t>(weight)
+                                                  : packWeights<uint32_t>(weight);
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Impossible d'ouvrir " + filename + " en écriture");
+    }
+    int32_t params[4] = {n, weightBytes, epsilon, 0};
+    out.write(CSR_MAGIC, sizeof(CSR_MAGIC));
+    out.write((const char*)params, sizeof(params));
+    out.write((const char*)&nnz, sizeof(nnz));
+    out.write((const char*)rowStart.data(), (std::streamsize)(rowStart.size() * sizeof(uint64_t)));
+    out.write((const char*)col.data(), (std::streamsize)(col.size() * sizeof(int32_t)));
+    out.write(packed.data(), (std::streamsize)packed.size());
+    if (!out) {
+        throw std::runtime_error("Erreur d'écriture dans " + filename);
+    }
+}
@@ -0,0 +1,41 @@
+#ifndef CSR_GRAPH_HPP
+#define CSR_GRAPH_HPP
+
+#include <string>
+#include <vector>
+#include "EdgeList.hpp"
+
+/**
+ * @file CsrGraph.hpp
+ * @brief Écriture du graphe au format binaire CSR (--csr=F), lu directement
+ *        par main_mpi (Floyd) sans passer par Graphviz.
+ *
+ * Format (ordre des octets de la machine), relu par CsrGraph.cpp côté Floyd :
+ * @code
+ *   "GRAPHCSR"                      8 octets
+ *   n, octets par poids, epsilon, 0 4 × int32
+ *   nnz                             uint64 (2 × nombre d'arêtes)
+ *   rowStart[n + 1]                 uint64 : voisins de i dans [rowStart[i], rowStart[i + 1])
+ *   col[nnz]                        int32, croissants dans chaque ligne
+ *   weight[nnz]                     entiers non signés de 1, 2 ou 4 octets
+ * @endcode
+ *
+ * Le graphe est non orienté : chaque arête (i, j) apparaît dans la ligne i et
+ * dans la ligne j, pour que chaque ligne se lise sans rien reconstruire. Les
+ * poids prennent le plus petit nombre d'octets qui contient la plus grande
+ * distance (1 octet pour la distance de Hamming usuelle, epsilon = 70).
+ * Tous les tableaux commencent à un multiple de leur taille d'élément : le
+ * fichier peut être projeté en mémoire (mmap) et lu sur place.
+ */
+
+/**
+ * @brief Écrit les arêtes d < epsilon d'un graphe à n sommets au format CSR.
+ *
+ * @param edges Arêtes (i < j), dans n'importe quel ordre.
+ *
+ * @throw std::runtime_error si le fichier ne peut pas être écrit.
+ */
+void writeCsrGraph(const std::string& filename, const std::vector<Edge>& edges,
+                   int epsilon, int n);
+
+#endif // CSR_GRAPH_HPP
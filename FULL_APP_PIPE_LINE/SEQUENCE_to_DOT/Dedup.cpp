@@ -0,0 +1,19 @@
+#include "Dedup.hpp"
+#include <fstream>
+#include <stdexcept>
+
+void writeGroups(const std::string& filename, const SeqGroups& g) {
+    std::ofstream out(filename);
+    if (!out) {
+        throw std::runtime_error("Impossible d'ouvrir " + filename + " en écriture");
+    }
+
+    out << "# sequences sommets\n";
+    out << g.nSequences << " " << g.rep.size() << "\n";
+    out << "# sommet multiplicite sequences...\n";
+    for (std::size_t u = 0; u < g.members.size(); ++u) {
+        out << u << " " << g.members[u].size();
+        for (int s : g.members[u]) out << " " << s;
+        out << "\n";
+    }
+}
@@ -0,0 +1,107 @@
+#ifndef DEDUP_HPP
+#define DEDUP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @file Dedup.hpp
+ * @brief Regroupement des séquences identiques (--dedup).
+ *
+ * Des séquences identiques sont à distance 0 : on ne garde qu'un sommet par
+ * séquence distincte, avec sa multiplicité (le nombre de copies). Floyd–Warshall
+ * travaille sur moins de sommets, et PAM compte chaque sommet autant de fois
+ * que sa multiplicité (voir PAM_MPI).
+ *
+ * Ce n'est pas le même graphe que sans --dedup. Sans regroupement, deux copies
+ * sont reliées par une arête de poids 0, que Floyd–Warshall lit comme « pas
+ * d'arête » (0 = absence d'arête dans la matrice d'adjacence) : les copies ne
+ * sont reliées qu'en passant par un autre sommet, donc à distance > 0. Avec
+ * --dedup, elles forment un seul sommet, à distance 0 d'elles-mêmes. Les
+ * distances, le coût et les médoïdes de PAM peuvent donc différer.
+ */
+
+/**
+ * @struct SeqGroups
+ * @brief Séquences distinctes et copies de chacune.
+ *
+ * Le sommet u du graphe correspond à la séquence rep[u] du FASTA (sa première
+ * apparition) ; members[u] liste toutes ses copies, par indice croissant.
+ */
+struct SeqGroups {
+    int nSequences = 0;                    /**< Nombre de séquences du FASTA. */
+    std::vector<int> rep;                  /**< Représentant (première copie) de chaque sommet. */
+    std::vector<std::vector<int>> members; /**< Copies de chaque sommet (rep[u] en premier). */
+};
+
+/**
+ * @brief Hachage FNV-1a de size octets, à partir de h.
+ */
+inline uint64_t hashBytes(const void* data, std::size_t size,
+                          uint64_t h = 0xcbf29ce484222325ULL)
+{
+    const unsigned char* p = (const unsigned char*)data;
+    for (std::size_t k = 0; k < size; ++k) {
+        h ^= p[k];
+        h *= 0x100000001b3ULL;
+    }
+    return h;
+}
+
+/**
+ * @brief Regroupe les n séquences identiques.
+ *
+ * @param hashOf hashOf(i) : hachage de la séquence i (égal pour des séquences égales).
+ * @param equal  equal(a, b) : vrai si les séquences a et b sont identiques
+ *               (vérifié à chaque fois, une collision de hachage ne fusionne rien).
+ * @return Les groupes, numérotés dans l'ordre de première apparition.
+ */
+template <typename H, typename E>
+SeqGroups groupDuplicates(int n, H&& hashOf, E&& equal) {
+    SeqGroups g;
+    g.nSequences = n;
+    // hachage -> sommets déjà vus avec ce hachage (presque toujours un seul)
+    std::unordered_map<uint64_t, std::vector<int>> seen;
+    seen.reserve((std::size_t)n);
+
+    for (int i = 0; i < n; ++i) {
+        std::vector<int>& bucket = seen[hashOf(i)];
+        int found = -1;
+        for (int u : bucket) {
+            if (equal(g.rep[u], i)) {
+                found = u;
+                break;
+            }
+        }
+        if (found < 0) {
+            found = (int)g.rep.size();
+            bucket.push_back(found);
+            g.rep.push_back(i);
+            g.members.emplace_back();
+        }
+        g.members[found].push_back(i);
+    }
+    return g;
+}
+
+/**
+ * @brief Écrit les groupes dans un fichier texte, lu ensuite par pam_mpi.
+ *
+ * Format :
+ * @code
+ *   # sequences sommets
+ *   2000 1990
+ *   # sommet multiplicite sequences...
+ *   0 1 0
+ *   1 2 1 57
+ *   ...
+ * @endcode
+ *
+ * @throw std::runtime_error si le fichier ne peut pas être ouvert.
+ */
+void writeGroups(const std::string& filename, const SeqGroups& g);
+
+#endif // DEDUP_HPP
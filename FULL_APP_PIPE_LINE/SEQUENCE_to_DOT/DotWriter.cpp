@@ -0,0 +1,133 @@
+#define OMPI_SKIP_MPICXX 1
+#include "DotWriter.hpp"
+#include <algorithm>
+#include <charconv>
+#include <cstring>
+#include <stdexcept>
+
+// Tampon de sortie : les caractères sont écrits directement à la position
+// courante (pas de vérification de place à chaque ajout, contrairement à
+// std::string::operator+=) ; reserve() garantit la place d'une ligne entière.
+struct DotBuffer {
+    std::vector<char> data;
+    std::size_t pos = 0;
+
+    void reserve(std::size_t bytes) {
+        if (data.size() - pos < bytes) data.resize(std::max(2 * data.size(), pos + bytes));
+    }
+    template <std::size_t N>
+    void put(const char (&s)[N]) {
+        std::memcpy(&data[pos], s, N - 1);
+        pos += N - 1;
+    }
+    void put(const std::string& s) {
+        reserve(s.size());
+        std::memcpy(&data[pos], s.data(), s.size());
+        pos += s.size();
+    }
+    void putInt(long long v) {
+        pos = std::to_chars(&data[pos], &data[pos] + 20, v).ptr - data.data();
+    }
+};
+
+// Place suffisante pour une ligne de sommet ou d'arête (entiers de 20 chiffres au plus)
+static const std::size_t DOT_LINE_MAX = 128;
+
+void writeDotGraph(const std::string& filename,
+                   const std::vector<Edge>& edges,
+                   int epsilon,
+                   int n,
+                   const std::string& distanceName,
+                   const SeqGroups* groups,
+                   MPI_Comm comm)
+{
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // Une ligne d'arête fait une quarantaine d'octets
+    DotBuffer buf;
+    buf.data.resize(edges.size() * 48 + (rank == 0 ? (size_t)n * 40 + 256 : 0) + DOT_LINE_MAX);
+
+    if (rank == 0) {
+        buf.put("graph graphe_pondere {\n");
+        buf.reserve(DOT_LINE_MAX);
+        buf.put("    node [shape=circle, style=filled, color=lightyellow, fontcolor=black];\n");
+        buf.reserve(DOT_LINE_MAX);
+        buf.put("    edge [color=black, fontcolor=blue];\n\n");
+
+        // Déclaration des sommets : A1, A2, ..., An
+        // label = indice de la séquence (0,1,2,...)
+        for (int i = 0; i < n; ++i) {
+            buf.reserve(DOT_LINE_MAX);
+            buf.put("    A");
+            buf.putInt(i + 1);
+            buf.put(" [label=\"");
+            if (groups) {
+                buf.putInt(groups->rep[i]);
+                buf.put("\", count=");
+                buf.putInt((long long)groups->members[i].size());
+                buf.put("];\n");
+            } else {
+                buf.putInt(i);
+                buf.put("\"];\n");
+            }
+        }
+        buf.put("\n    // Les aretes avec poids (" + distanceName + " < ");
+        buf.reserve(DOT_LINE_MAX);
+        buf.putInt(epsilon);
+        buf.put(")\n");
+    }
+
+    // Arêtes non orientées : i < j
+    for (const Edge& e : edges) {
+        if (e.d >= epsilon) continue;
+        buf.reserve(DOT_LINE_MAX);
+        buf.put("    A");
+        buf.putInt(e.i + 1);
+        buf.put(" -- A");
+        buf.putInt(e.j + 1);
+        buf.put(" [label=\"");
+        buf.putInt(e.d);
+        buf.put("\", weight=");
+        buf.putInt(e.d);
+        buf.put("];\n");
+    }
+
+    if (rank == size - 1) {
+        buf.reserve(DOT_LINE_MAX);
+        buf.put("}\n");
+    }
+
+    // Mon tampon commence après ceux des rangs précédents
+    long long bytes = (long long)buf.pos;
+    long long offset = 0;
+    MPI_Exscan(&bytes, &offset, 1, MPI_LONG_LONG, MPI_SUM, comm);
+    if (rank == 0) offset = 0;   // MPI_Exscan ne remplit pas le rang 0
+
+    MPI_File fh;
+    int rc = MPI_File_open(comm, filename.c_str(), MPI_MODE_WRONLY | MPI_MODE_CREATE,
+                           MPI_INFO_NULL, &fh);
+    if (rc != MPI_SUCCESS) {
+        throw std::runtime_error("Impossible d'ouvrir " + filename + " en écriture");
+    }
+    // L'ancien fichier peut être plus long que le nouveau
+    MPI_File_set_size(fh, 0);
+
+    // Par morceaux de 1 Go : le nombre d'éléments d'une écriture MPI est un int
+    const long long CHUNK = 1LL << 30;
+    bool ok = true;
+    for (long long done = 0; done < bytes && ok; done += CHUNK) {
+        const int count = (int)std::min(CHUNK, bytes - done);
+        ok = MPI_File_write_at(fh, (MPI_Offset)(offset + done), buf.data.data() + done, count,
+                               MPI_CHAR, MPI_STATUS_IGNORE) == MPI_SUCCESS;
+    }
+    MPI_File_close(&fh);
+
+    // Tous les rangs signalent l'erreur, même ceux dont l'écriture a réussi
+    int allOk = ok ? 1 : 0;
+    MPI_Allreduce(MPI_IN_PLACE, &allOk, 1, MPI_INT, MPI_MIN, comm);
+    if (!allOk) {
+        throw std::runtime_error("Erreur d'ecriture dans " + filename);
+    }
+}
@@ -0,0 +1,60 @@
+#ifndef DOT_WRITER_HPP
+#define DOT_WRITER_HPP
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+#include "Dedup.hpp"
+#include "EdgeList.hpp"
+
+/**
+ * @file DotWriter.hpp
+ * @brief Écriture du graphe DOT par tous les rangs à la fois (MPI-IO).
+ *
+ * Avec plusieurs millions d'arêtes, formater chaque entier avec un
+ * std::ofstream sur le seul rang 0 prend une part visible du temps total.
+ * Ici chaque rang formate sa tranche d'arêtes (déjà triée) dans un seul grand
+ * tampon avec std::to_chars, puis une somme préfixe (MPI_Exscan) des tailles
+ * donne à chacun l'endroit du fichier où écrire son tampon (MPI_File_write_at).
+ * Le rang 0 écrit en plus l'en-tête et les sommets, le dernier rang l'accolade
+ * finale : le fichier est le même que celui écrit par un seul rang.
+ */
+
+/**
+ * @brief Écrit un graphe pondéré non orienté au format DOT (collectif sur comm).
+ *
+ * Format :
+ * @code
+ *   graph graphe_pondere {
+ *     A1 [label="0"];
+ *     ...
+ *     A1 -- A2 [label="d", weight=d];
+ *     ...
+ *   }
+ * @endcode
+ *
+ * Les arêtes de chaque rang sont écrites dans l'ordre des rangs : pour un
+ * fichier trié, les tranches doivent être consécutives (voir scatterEdges).
+ * Avec MPI_COMM_SELF, un seul rang écrit tout le fichier.
+ *
+ * @param filename     Nom du fichier DOT à générer (écrasé s'il existe).
+ * @param edges        Tranche d'arêtes de ce rang ; seules celles avec d < epsilon sont écrites.
+ * @param epsilon      Seuil du graphe.
+ * @param n            Nombre de sommets.
+ * @param distanceName Nom de la distance, pour le commentaire du fichier.
+ * @param groups       Avec --dedup : séquences de chaque sommet (lu sur le rang 0 seulement).
+ *                     Le label devient l'indice du représentant, et count sa multiplicité.
+ * @param comm         Rangs qui écrivent ensemble.
+ *
+ * @throw std::runtime_error si le fichier ne peut pas être ouvert ou écrit
+ *        (sur tous les rangs de comm).
+ */
+void writeDotGraph(const std::string& filename,
+                   const std::vector<Edge>& edges,
+                   int epsilon,
+                   int n,
+                   const std::string& distanceName,
+                   const SeqGroups* groups,
+                   MPI_Comm comm);
+
+#endif // DOT_WRITER_HPP
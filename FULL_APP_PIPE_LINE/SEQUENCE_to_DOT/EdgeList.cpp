@@ -0,0 +1,150 @@
+#define OMPI_SKIP_MPICXX 1
+#include "EdgeList.hpp"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+// Début de tout fichier d'arêtes (le 1 est la version du format)
+static const char EDGE_MAGIC[8] = {'E', 'D', 'G', 'E', 'L', 'S', 'T', '1'};
+
+std::vector<Edge> gatherEdges(const std::vector<Edge>& local, int root, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    // Une arête = 3 entiers contigus, je la décris comme un type MPI
+    MPI_Datatype edgeType;
+    MPI_Type_contiguous(3, MPI_INT, &edgeType);
+    MPI_Type_commit(&edgeType);
+
+    // D'abord chaque rang annonce combien d'arêtes il envoie
+    int localCount = (int)local.size();
+    std::vector<int> counts, displs;
+    if (rank == root) {
+        counts.resize(size);
+        displs.resize(size);
+    }
+    MPI_Gather(&localCount, 1, MPI_INT, counts.data(), 1, MPI_INT, root, comm);
+
+    std::vector<Edge> all;
+    if (rank == root) {
+        int total = 0;
+        for (int r = 0; r < size; ++r) {
+            displs[r] = total;
+            total += counts[r];
+        }
+        all.resize(total);
+    }
+
+    // Puis les listes elles-mêmes, de tailles différentes
+    MPI_Gatherv(local.data(), localCount, edgeType,
+                all.data(), counts.data(), displs.data(), edgeType,
+                root, comm);
+
+    MPI_Type_free(&edgeType);
+    return all;
+}
+
+std::vector<Edge> scatterEdges(const std::vector<Edge>& all, int root, MPI_Comm comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    MPI_Datatype edgeType;
+    MPI_Type_contiguous(3, MPI_INT, &edgeType);
+    MPI_Type_commit(&edgeType);
+
+    long long total = (rank == root) ? (long long)all.size() : 0;
+    MPI_Bcast(&total, 1, MPI_LONG_LONG, root, comm);
+
+    // Tranches de même taille, à une arête près
+    std::vector<int> counts(size), displs(size);
+    for (int r = 0; r < size; ++r) {
+        displs[r] = (int)(total * r / size);
+        counts[r] = (int)(total * (r + 1) / size) - displs[r];
+    }
+
+    std::vector<Edge> mine(counts[rank]);
+    MPI_Scatterv(all.data(), counts.data(), displs.data(), edgeType,
+                 mine.data(), counts[rank], edgeType, root, comm);
+
+    MPI_Type_free(&edgeType);
+    return mine;
+}
+
+void sortEdges(std::vector<Edge>& edges) {
+    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) {
+        return a.i < b.i || (a.i == b.i && a.j < b.j);
+    });
+}
+
+void saveEdges(const std::string& filename, const EdgeFileHeader& header,
+               const std::vector<Edge>& edges)
+{
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) {
+        throw std::runtime_error("Impossible d'ouvrir " + filename + " en écriture");
+    }
+
+    int32_t params[4] = {header.n, header.epsilon, header.distance, (int32_t)header.model};
+    uint64_t sizes[2] = {header.fingerprint, (uint64_t)edges.size()};
+    out.write(EDGE_MAGIC, sizeof(EDGE_MAGIC));
+    out.write((const char*)params, sizeof(params));
+    out.write((const char*)sizes, sizeof(sizes));
+    out.write((const char*)edges.data(), (std::streamsize)(edges.size() * sizeof(Edge)));
+    if (!out) {
+        throw std::runtime_error("Erreur d'écriture dans " + filename);
+    }
+}
+
+std::vector<Edge> loadEdges(const std::string& filename, EdgeFileHeader& header) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) {
+        throw std::runtime_error("Impossible d'ouvrir " + filename);
+    }
+
+    char magic[8];
+    int32_t params[4];
+    uint64_t sizes[2];
+    in.read(magic, sizeof(magic));
+    in.read((char*)params, sizeof(params));
+    in.read((char*)sizes, sizeof(sizes));
+    if (!in || std::memcmp(magic, EDGE_MAGIC, sizeof(magic)) != 0) {
+        throw std::runtime_error(filename + " n'est pas un fichier d'aretes de build_dot");
+    }
+    header.n = params[0];
+    header.epsilon = params[1];
+    header.distance = params[2];
+    header.model = (uint32_t)params[3];
+    header.fingerprint = sizes[0];
+
+    std::vector<Edge> edges(sizes[1]);
+    in.read((char*)edges.data(), (std::streamsize)(edges.size() * sizeof(Edge)));
+    if (!in) {
+        throw std::runtime_error(filename + " est tronque");
+    }
+    return edges;
+}
+
+void writeTaggedEdges(const std::string& filename, const std::vector<int>& epsilons,
+                      const std::vector<Edge>& edges)
+{
+    std::ofstream out(filename);
+    if (!out) {
+        throw std::runtime_error("Impossible d'ouvrir " + filename + " en écriture");
+    }
+
+    out << "# seuils :";
+    for (int eps : epsilons) out << " " << eps;
+    out << "\n# i j d epsilon_min\n";
+    for (const Edge& e : edges) {
+        // Premier seuil strictement plus grand que d (les seuils sont croissants)
+        std::vector<int>::const_iterator it = std::upper_bound(epsilons.begin(), epsilons.end(), e.d);
+        if (it == epsilons.end()) continue;
+        out << e.i << " " << e.j << " " << e.d << " " << *it << "\n";
+    }
+    if (!out) {
+        throw std::runtime_error("Erreur d'écriture dans " + filename);
+    }
+}
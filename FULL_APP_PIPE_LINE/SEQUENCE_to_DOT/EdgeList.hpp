@@ -0,0 +1,119 @@
+#ifndef EDGE_LIST_HPP
+#define EDGE_LIST_HPP
+
+#include <mpi.h>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @file EdgeList.hpp
+ * @brief Liste d'arêtes (i, j, d) du graphe epsilon et rassemblement MPI.
+ *
+ * Au lieu de rassembler la matrice des distances complète sur le rang 0,
+ * chaque rang ne garde que les paires dont la distance est sous le seuil,
+ * puis les listes sont concaténées sur le rang 0. La mémoire et le volume
+ * de communication dépendent alors du nombre d'arêtes et plus de n².
+ */
+
+/**
+ * @struct Edge
+ * @brief Arête non orientée entre les séquences i et j (i < j), de poids d.
+ */
+struct Edge {
+    int i;   /**< Première extrémité (indice de séquence). */
+    int j;   /**< Deuxième extrémité, j > i. */
+    int d;   /**< Distance entre les deux séquences. */
+};
+
+/**
+ * @brief Concatène sur root les listes d'arêtes locales de tous les rangs.
+ *
+ * Les listes sont mises bout à bout dans l'ordre des rangs : si chaque rang
+ * a produit ses arêtes dans l'ordre de sa tranche de paires, le résultat
+ * est trié comme le triangle supérieur (i croissant, puis j croissant).
+ *
+ * @param local Arêtes trouvées par ce rang.
+ * @param root  Rang qui reçoit le résultat.
+ * @param comm  Communicateur MPI.
+ * @return Sur root : toutes les arêtes. Sur les autres rangs : un vecteur vide.
+ */
+std::vector<Edge> gatherEdges(const std::vector<Edge>& local, int root, MPI_Comm comm);
+
+/**
+ * @brief Redistribue les arêtes de root en tranches consécutives de même taille.
+ *
+ * Le rang r reçoit les arêtes [r * m / p, (r + 1) * m / p) de la liste de
+ * root (m arêtes) : l'ordre de la liste est conservé d'un rang au suivant.
+ *
+ * @param all  Sur root : toutes les arêtes. Ignoré ailleurs.
+ * @param root Rang qui possède la liste.
+ * @param comm Communicateur MPI.
+ * @return La tranche de ce rang.
+ */
+std::vector<Edge> scatterEdges(const std::vector<Edge>& all, int root, MPI_Comm comm);
+
+/**
+ * @brief Trie les arêtes par i croissant, puis j croissant.
+ */
+void sortEdges(std::vector<Edge>& edges);
+
+/**
+ * @struct EdgeFileHeader
+ * @brief Paramètres du calcul enregistrés avec les arêtes (--save-edges),
+ *        et vérifiés avant de les réutiliser (--append).
+ */
+struct EdgeFileHeader {
+    int n = 0;                 /**< Nombre de séquences du calcul. */
+    int epsilon = 0;           /**< Seuil des arêtes (d < epsilon). */
+    int distance = 0;          /**< Distance utilisée : 0 = Hamming, 1 = édition, 2 = pondérée. */
+    uint32_t model = 0;        /**< Empreinte des coûts et poids (distance pondérée), 0 sinon. */
+    uint64_t fingerprint = 0;  /**< Empreinte des n séquences (voir BuildMatrixMPI.cpp). */
+};
+
+/**
+ * @brief Enregistre une liste d'arêtes dans un fichier binaire.
+ *
+ * Format (ordre des octets de la machine) : "EDGELST1", n, epsilon, distance,
+ * modèle (int32), empreinte, nombre d'arêtes (uint64), puis les arêtes (3 int32 chacune).
+ *
+ * @throw std::runtime_error si le fichier ne peut pas être écrit.
+ */
+void saveEdges(const std::string& filename, const EdgeFileHeader& header,
+               const std::vector<Edge>& edges);
+
+/**
+ * @brief Relit un fichier écrit par saveEdges.
+ *
+ * @param filename Fichier d'arêtes.
+ * @param header   Rempli avec les paramètres enregistrés.
+ * @return Les arêtes, dans l'ordre du fichier.
+ *
+ * @throw std::runtime_error si le fichier est illisible, tronqué ou d'un autre format.
+ */
+std::vector<Edge> loadEdges(const std::string& filename, EdgeFileHeader& header);
+
+/**
+ * @brief Écrit les arêtes dans un fichier texte, avec pour chacune le plus
+ *        petit seuil dont le graphe la contient (--tagged-edges).
+ *
+ * Format :
+ * @code
+ *   # seuils : 50 60 70
+ *   # i j d epsilon_min
+ *   0 12 47 50
+ *   0 31 63 70
+ *   ...
+ * @endcode
+ *
+ * L'arête (i, j, d) est dans le graphe de seuil epsilon si d < epsilon, donc
+ * dans tous les graphes à partir de epsilon_min : un seul fichier décrit
+ * tous les graphes.
+ *
+ * @param epsilons Seuils, par ordre croissant.
+ * @throw std::runtime_error si le fichier ne peut pas être écrit.
+ */
+void writeTaggedEdges(const std::string& filename, const std::vector<int>& epsilons,
+                      const std::vector<Edge>& edges);
+
+#endif // EDGE_LIST_HPP
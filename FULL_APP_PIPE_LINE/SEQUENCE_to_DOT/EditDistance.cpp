@@ -0,0 +1,147 @@
+#include "EditDistance.hpp"
+#include <algorithm>
+#include <cstdlib>
+
+// Même codage que PackedSeqs : A = 0, C = 1, G = 2, T/U = 3, -1 sinon
+static inline int baseCode(char c) {
+    switch (c) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T':
+        case 'U': return 3;
+        default:  return -1;
+    }
+}
+
+EditSeqs buildEditSeqs(std::vector<char> chars, const std::vector<int>& lens) {
+    EditSeqs es;
+    es.n = (int)lens.size();
+    es.chars.swap(chars);
+    es.start.assign(es.n + 1, 0);
+    es.blockStart.assign(es.n + 1, 0);
+    for (int i = 0; i < es.n; ++i) {
+        es.start[i + 1] = es.start[i] + lens[i];
+        es.blockStart[i + 1] = es.blockStart[i] + (lens[i] + 63) / 64;
+    }
+
+    es.peq.assign(4 * es.blockStart[es.n], 0);
+    for (int i = 0; i < es.n; ++i) {
+        const char* s = &es.chars[es.start[i]];
+        uint64_t* peq = &es.peq[4 * es.blockStart[i]];
+        for (int p = 0; p < lens[i]; ++p) {
+            int c = baseCode(s[p]);
+            // Une base hors alphabet n'a aucun bit : elle ne correspond à aucune des 4
+            if (c >= 0) peq[4 * (p >> 6) + c] |= 1ULL << (p & 63);
+        }
+    }
+    return es;
+}
+
+// Masque "égal à c" du bloc blk de la séquence s, pour un caractère hors
+// alphabet (rare) : je compare directement les caractères du bloc.
+static uint64_t otherMask(const char* s, int len, int blk, char c) {
+    uint64_t eq = 0;
+    int p0 = blk * 64;
+    int p1 = std::min(len, p0 + 64);
+    for (int p = p0; p < p1; ++p) {
+        if (s[p] == c) eq |= 1ULL << (p - p0);
+    }
+    return eq;
+}
+
+// Avance un bloc de 64 lignes d'une colonne (Myers 1999, version par blocs de Hyyrö).
+// Pv / Mv : différences verticales +1 / -1 du bloc, Eq : lignes égales à la base
+// de la colonne, hin : différence horizontale en haut du bloc (-1, 0 ou +1).
+// Renvoie la différence horizontale sur la dernière ligne du bloc (bit hmask).
+static inline int advanceBlock(uint64_t& Pv, uint64_t& Mv, uint64_t Eq, int hin, uint64_t hmask) {
+    uint64_t Xv = Eq | Mv;
+    if (hin < 0) Eq |= 1;
+    uint64_t Xh = (((Eq & Pv) + Pv) ^ Pv) | Eq;
+    uint64_t Ph = Mv | ~(Xh | Pv);
+    uint64_t Mh = Pv & Xh;
+
+    int hout = 0;
+    if (Ph & hmask) hout = 1;
+    else if (Mh & hmask) hout = -1;
+
+    Ph <<= 1;
+    Mh <<= 1;
+    if (hin < 0) Mh |= 1;
+    else if (hin > 0) Ph |= 1;
+
+    Pv = Mh | ~(Xv | Ph);
+    Mv = Ph & Xv;
+    return hout;
+}
+
+int editDistanceBounded(const EditSeqs& es, int a, int b, int bound) {
+    const int m = es.length(a);
+    const int nb = es.length(b);
+    // Il faut au moins |m - nb| insertions ou suppressions
+    if (std::abs(m - nb) >= bound) return bound;
+    if (m == 0) return nb;
+    if (nb == 0) return m;
+
+    const char* sa = &es.chars[es.start[a]];
+    const char* sb = &es.chars[es.start[b]];
+    const uint64_t* peq = &es.peq[4 * es.blockStart[a]];
+    const int k = bound - 1;                  // plus grande distance utile
+    const int blocks = (m + 63) / 64;
+    const uint64_t lastMask = 1ULL << ((m - 1) & 63);
+
+    // État des blocs encore actifs [first, last] ; score[blk] = valeur de D
+    // sur la dernière ligne du bloc, dans la colonne courante.
+    thread_local std::vector<uint64_t> P, M;
+    thread_local std::vector<int> score;
+    if ((int)P.size() < blocks) {
+        P.resize(blocks);
+        M.resize(blocks);
+        score.resize(blocks);
+    }
+    auto rows = [&](int blk) { return std::min(64, m - blk * 64); };
+
+    // Colonne 0 : D[i][0] = i
+    int first = 0, last = 0;
+    P[0] = ~0ULL;
+    M[0] = 0;
+    score[0] = rows(0);
+
+    for (int j = 1; j <= nb; ++j) {
+        const char c = sb[j - 1];
+        const int code = baseCode(c);
+
+        // Les lignes i > j + k ont D[i][j] >= i - j > k : je n'ajoute un bloc que
+        // quand la bande l'atteint. Ses valeurs de la colonne précédente sont
+        // majorées par "+1 à chaque ligne", ce qui ne change rien aux cases <= k.
+        const int want = std::min(blocks - 1, (j + k - 1) / 64);
+        while (last < want) {
+            ++last;
+            P[last] = ~0ULL;
+            M[last] = 0;
+            score[last] = score[last - 1] + rows(last);
+        }
+
+        // En haut, D[0][j] = j (+1 par colonne). Si les blocs du haut ont été
+        // abandonnés, +1 reste un majorant : ces cases dépassent déjà k.
+        int h = 1;
+        for (int blk = first; blk <= last; ++blk) {
+            uint64_t eq = (code >= 0) ? peq[4 * blk + code] : otherMask(sa, m, blk, c);
+            h = advanceBlock(P[blk], M[blk], eq, h, (blk == blocks - 1) ? lastMask : (1ULL << 63));
+            score[blk] += h;
+        }
+
+        // J'abandonne les blocs du haut dont toutes les cases dépassent k :
+        // soit au-dessus de la bande (i < j - k), soit parce que le minimum du
+        // bloc (au moins score - (rows - 1), D varie de 1 au plus d'une ligne
+        // à l'autre) dépasse k. Aucun chemin de coût <= k n'y passe plus.
+        while (first <= last
+               && (first * 64 + rows(first) < j - k || score[first] - (rows(first) - 1) > k)) {
+            ++first;
+        }
+        if (first > last) return bound;
+    }
+
+    // À la fin, la bande contient la ligne m puisque |m - nb| <= k
+    return std::min(score[blocks - 1], bound);
+}
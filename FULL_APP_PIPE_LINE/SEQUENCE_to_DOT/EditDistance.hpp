@@ -0,0 +1,67 @@
+#ifndef EDIT_DISTANCE_HPP
+#define EDIT_DISTANCE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file EditDistance.hpp
+ * @brief Distance d'édition (Levenshtein) bornée, calculée 64 lignes à la fois
+ *        avec l'algorithme bit-parallèle de Myers / Hyyrö.
+ *
+ * Contrairement à la distance de Hamming, les séquences peuvent avoir des
+ * longueurs différentes et une insertion ou une suppression ne coûte que 1
+ * (au lieu de décaler toute la fin de la séquence).
+ *
+ * La matrice de programmation dynamique D (m lignes pour a, une colonne par
+ * base de b) est découpée en blocs de 64 lignes. Pour chaque bloc, on garde
+ * seulement les différences verticales D[i][j] - D[i-1][j] sous forme de deux
+ * masques (+1 / -1), et une colonne de 64 cases se calcule en une dizaine
+ * d'opérations sur des mots de 64 bits.
+ *
+ * Comme le graphe ne garde que les paires avec d < epsilon, seule une bande
+ * diagonale |i - j| < epsilon est utile : les blocs hors de cette bande ne sont
+ * jamais calculés, ceux du haut sont abandonnés dès que toutes leurs cases
+ * dépassent le seuil, et le calcul s'arrête quand il ne reste plus aucun bloc.
+ *
+ * Alphabet : comme pour PackedSeqs, A, C, G, T/U (T et U sont égaux) ; les
+ * autres caractères ne sont égaux qu'au même caractère.
+ */
+
+/**
+ * @struct EditSeqs
+ * @brief n séquences de longueurs quelconques, prêtes pour la distance d'édition.
+ *
+ * La séquence i est chars[start[i] .. start[i + 1]). Ses blocs de 64 bases
+ * commencent au bloc blockStart[i], et le bloc numéro b a 4 masques
+ * peq[4 * b + c] : le bit t vaut 1 si la base t du bloc est la base c (A, C, G, T/U).
+ */
+struct EditSeqs {
+    int n = 0;                        /**< Nombre de séquences. */
+    std::vector<char> chars;          /**< Toutes les séquences à la suite. */
+    std::vector<std::size_t> start;   /**< Début de chaque séquence dans chars (taille n + 1). */
+    std::vector<std::size_t> blockStart; /**< Premier bloc de chaque séquence (taille n + 1). */
+    std::vector<uint64_t> peq;        /**< 4 masques par bloc de 64 bases. */
+
+    /** @brief Longueur de la séquence i. */
+    int length(int i) const { return (int)(start[i + 1] - start[i]); }
+};
+
+/**
+ * @brief Prépare les masques de n séquences stockées à la suite.
+ *
+ * @param chars Séquences à la suite (déplacées dans le résultat).
+ * @param lens  Longueur de chaque séquence.
+ */
+EditSeqs buildEditSeqs(std::vector<char> chars, const std::vector<int>& lens);
+
+/**
+ * @brief Distance d'édition entre les séquences a et b, bornée par bound.
+ *
+ * @return min(distance(a, b), bound) : le calcul s'arrête dès qu'on sait
+ *         que la distance atteint bound.
+ */
+int editDistanceBounded(const EditSeqs& es, int a, int b, int bound);
+
+#endif // EDIT_DISTANCE_HPP
@@ -0,0 +1,225 @@
+#define OMPI_SKIP_MPICXX 1
+#include "FastaReader.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Projection en lecture seule d'un fichier, libérée automatiquement.
+// Les pages ne sont vraiment lues que quand on y touche : chaque rang
+// ne charge donc que sa tranche (plus un bout de la suivante).
+struct MappedFile {
+    const char* data = nullptr;
+    size_t size = 0;
+    bool ok = false;
+
+    explicit MappedFile(const std::string& filename) {
+        int fd = open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0) {
+            size = (size_t)st.st_size;
+            if (size == 0) {
+                ok = true;
+            } else {
+                void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p != MAP_FAILED) {
+                    madvise(p, size, MADV_SEQUENTIAL);
+                    data = (const char*)p;
+                    ok = true;
+                }
+            }
+        }
+        close(fd);
+    }
+
+    ~MappedFile() {
+        if (data) munmap((void*)data, size);
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+};
+
+// Premier début d'enregistrement ('>' en début de ligne) à partir de pos.
+// Renvoie size s'il n'y en a plus.
+static size_t nextRecord(const char* buf, size_t size, size_t pos) {
+    while (pos < size) {
+        if (buf[pos] == '>' && (pos == 0 || buf[pos - 1] == '\n')) return pos;
+        // Sinon je saute directement au début de la ligne suivante
+        const void* nl = std::memchr(buf + pos, '\n', size - pos);
+        if (!nl) return size;
+        pos = (size_t)((const char*)nl - buf) + 1;
+    }
+    return size;
+}
+
+// Début (avant recalage) de la tranche d'octets du rang r
+static size_t sliceStart(size_t S, int r, int p) {
+    return (size_t)((unsigned long long)S * r / p);
+}
+
+// Caractères ignorés à l'intérieur d'une séquence (fins de ligne, blancs)
+static inline bool isBlank(char c) {
+    return c == '\n' || c == '\r' || c == ' ' || c == '\t';
+}
+
+// Lève la même exception sur tous les rangs si l'un d'eux a échoué,
+// pour que personne ne reste bloqué dans une communication collective.
+static void checkAll(bool localOk, const std::string& msg, MPI_Comm comm) {
+    int ok = localOk ? 1 : 0;
+    int allOk = 0;
+    MPI_Allreduce(&ok, &allOk, 1, MPI_INT, MPI_MIN, comm);
+    if (!allOk) throw std::runtime_error(msg);
+}
+
+FastaPart readFastaPart(const std::string& filename, MPI_Comm comm, bool sameLength) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+
+    MappedFile file(filename);
+    checkAll(file.ok, "Impossible d'ouvrir " + filename, comm);
+
+    const char* buf = file.data;
+    const size_t S = file.size;
+
+    // Ma tranche d'octets [S*r/p, S*(r+1)/p), recalée sur les débuts d'enregistrement.
+    // Le rang suivant fait le même calcul pour son début, donc les tranches
+    // se suivent sans trou ni recouvrement.
+    size_t begin = nextRecord(buf, S, sliceStart(S, rank, size));
+    size_t end   = (rank == size - 1) ? S : nextRecord(buf, S, sliceStart(S, rank + 1, size));
+
+    // ----- Passe 1 : repérer mes enregistrements et mesurer les séquences -----
+    std::vector<size_t> seqBegin, seqEnd;
+    std::vector<int> seqLen;
+    size_t totalLen = 0;
+    int minLen = INT_MAX;
+    int maxLen = 0;
+
+    size_t rec = begin;
+    while (rec < end) {
+        // La séquence commence après la ligne d'en-tête
+        const void* nl = std::memchr(buf + rec, '\n', end - rec);
+        size_t sBegin = nl ? (size_t)((const char*)nl - buf) + 1 : end;
+        size_t next = nextRecord(buf, end, sBegin);
+
+        int len = 0;
+        for (size_t k = sBegin; k < next; ++k) {
+            if (!isBlank(buf[k])) ++len;
+        }
+        if (len > 0) {
+            seqBegin.push_back(sBegin);
+            seqEnd.push_back(next);
+            seqLen.push_back(len);
+            totalLen += len;
+            minLen = std::min(minLen, len);
+            maxLen = std::max(maxLen, len);
+        }
+        rec = next;
+    }
+
+    // ----- Mise en commun : nombre de séquences et longueur -----
+    FastaPart part;
+    part.count = (int)seqBegin.size();
+
+    std::vector<int> counts(size);
+    MPI_Allgather(&part.count, 1, MPI_INT, counts.data(), 1, MPI_INT, comm);
+    for (int r = 0; r < size; ++r) {
+        if (r < rank) part.first += counts[r];
+        part.n += counts[r];
+    }
+    if (part.n == 0) {
+        throw std::runtime_error("Aucune sequence lue dans " + filename);
+    }
+
+    // Je veux le min et le max des longueurs sur tous les rangs en une seule
+    // réduction : min(x) = -max(-x).
+    int lens[2] = {-minLen, maxLen};
+    MPI_Allreduce(MPI_IN_PLACE, lens, 2, MPI_INT, MPI_MAX, comm);
+    if (sameLength && -lens[0] != lens[1]) {
+        throw std::runtime_error("Les sequences n'ont pas toutes la meme longueur (min = "
+                                 + std::to_string(-lens[0]) + ", max = "
+                                 + std::to_string(lens[1]) + ")");
+    }
+    part.L = lens[1];
+    part.lens.swap(seqLen);
+
+    // ----- Passe 2 : copie directe dans le tableau contigu -----
+    part.seqs.resize(totalLen);
+    char* out = part.seqs.data();
+    for (int s = 0; s < part.count; ++s) {
+        for (size_t k = seqBegin[s]; k < seqEnd[s]; ++k) {
+            if (!isBlank(buf[k])) *out++ = buf[k];
+        }
+    }
+
+    return part;
+}
+
+std::vector<char> allgatherFasta(const FastaPart& part, MPI_Comm comm) {
+    int size;
+    MPI_Comm_size(comm, &size);
+
+    std::vector<int> counts(size), displs(size);
+    MPI_Allgather(&part.count, 1, MPI_INT, counts.data(), 1, MPI_INT, comm);
+    for (int r = 0, total = 0; r < size; ++r) {
+        displs[r] = total;
+        total += counts[r];
+    }
+
+    // Je compte en séquences (type = L caractères) et pas en caractères,
+    // pour ne pas dépasser la limite des int avec de gros fichiers.
+    MPI_Datatype seqType;
+    MPI_Type_contiguous(part.L, MPI_CHAR, &seqType);
+    MPI_Type_commit(&seqType);
+
+    std::vector<char> all((size_t)part.n * part.L);
+    MPI_Allgatherv(part.seqs.data(), part.count, seqType,
+                   all.data(), counts.data(), displs.data(), seqType, comm);
+
+    MPI_Type_free(&seqType);
+    return all;
+}
+
+std::vector<char> allgatherFastaVariable(const FastaPart& part, std::vector<int>& lens, MPI_Comm comm) {
+    int size;
+    MPI_Comm_size(comm, &size);
+
+    // D'abord les longueurs (un int par séquence), placées comme les séquences
+    std::vector<int> counts(size), displs(size);
+    MPI_Allgather(&part.count, 1, MPI_INT, counts.data(), 1, MPI_INT, comm);
+    for (int r = 0, total = 0; r < size; ++r) {
+        displs[r] = total;
+        total += counts[r];
+    }
+    lens.resize(part.n);
+    MPI_Allgatherv(part.lens.data(), part.count, MPI_INT,
+                   lens.data(), counts.data(), displs.data(), MPI_INT, comm);
+
+    // Puis les caractères : ici il n'y a pas de type "une séquence",
+    // donc les comptes sont en caractères et doivent tenir dans un int.
+    std::vector<long long> chars(size, 0);
+    for (int r = 0, s = 0; r < size; ++r) {
+        for (int k = 0; k < counts[r]; ++k) chars[r] += lens[s++];
+    }
+    long long total = 0;
+    for (int r = 0; r < size; ++r) {
+        displs[r] = (int)total;
+        counts[r] = (int)chars[r];
+        total += chars[r];
+    }
+    if (total > INT_MAX) {
+        throw std::runtime_error("Trop de caracteres pour MPI_Allgatherv ("
+                                 + std::to_string(total) + ")");
+    }
+
+    std::vector<char> all((size_t)total);
+    MPI_Allgatherv(part.seqs.data(), (int)part.seqs.size(), MPI_CHAR,
+                   all.data(), counts.data(), displs.data(), MPI_CHAR, comm);
+    return all;
+}
@@ -0,0 +1,78 @@
+#ifndef FASTA_READER_HPP
+#define FASTA_READER_HPP
+
+#include <mpi.h>
+#include <string>
+#include <vector>
+
+/**
+ * @file FastaReader.hpp
+ * @brief Lecture parallèle d'un fichier FASTA : chaque rang lit sa part du fichier.
+ *
+ * Le fichier est projeté en mémoire (mmap) sur chaque rang, puis découpé en
+ * p tranches d'octets de même taille. Chaque tranche est recalée sur un début
+ * d'enregistrement ('>' en début de ligne), de sorte que chaque enregistrement
+ * appartient à exactement un rang. Chaque rang analyse ses enregistrements
+ * directement dans un tableau contigu (sans passer par des std::string).
+ *
+ * Le fichier doit être visible par tous les rangs (système de fichiers partagé) ;
+ * sinon il faut garder la lecture sur le rang 0 (--reader=rank0).
+ */
+
+/**
+ * @struct FastaPart
+ * @brief Séquences lues par un rang, et leur place dans l'ensemble complet.
+ *
+ * Les séquences du rang r sont les séquences first .. first + count - 1
+ * du fichier, stockées à la suite dans seqs. Elles ont toutes la longueur L,
+ * sauf si on a accepté des longueurs différentes (voir readFastaPart).
+ */
+struct FastaPart {
+    int n = 0;               /**< Nombre total de séquences dans le fichier. */
+    int L = 0;               /**< Longueur commune des séquences (la plus grande si elles diffèrent). */
+    int first = 0;           /**< Indice global de la première séquence de ce rang. */
+    int count = 0;           /**< Nombre de séquences lues par ce rang. */
+    std::vector<int> lens;   /**< Longueur de chacune des count séquences. */
+    std::vector<char> seqs;  /**< Les count séquences à la suite (count * L caractères si même longueur). */
+};
+
+/**
+ * @brief Lit en parallèle la part du fichier FASTA qui revient à ce rang.
+ *
+ * Fonction collective : tous les rangs de comm doivent l'appeler.
+ * Les fins de ligne (\\n ou \\r\\n) et les blancs dans les séquences sont ignorés,
+ * les enregistrements sans séquence aussi (comme dans readFasta).
+ *
+ * @param filename   Chemin du fichier FASTA.
+ * @param comm       Communicateur MPI.
+ * @param sameLength true pour exiger des séquences de même longueur (Hamming).
+ * @return La part de ce rang (n et L sont identiques sur tous les rangs).
+ *
+ * @throw std::runtime_error sur tous les rangs si le fichier ne peut pas être lu,
+ *        s'il ne contient aucune séquence, ou si les longueurs diffèrent
+ *        alors que sameLength est vrai.
+ */
+FastaPart readFastaPart(const std::string& filename, MPI_Comm comm, bool sameLength = true);
+
+/**
+ * @brief Rassemble sur tous les rangs les séquences lues par chacun.
+ *
+ * @param part Part lue par ce rang (voir readFastaPart).
+ * @param comm Communicateur MPI.
+ * @return Tableau contigu de part.n * part.L caractères, la séquence i à l'offset i * L.
+ */
+std::vector<char> allgatherFasta(const FastaPart& part, MPI_Comm comm);
+
+/**
+ * @brief Comme allgatherFasta, pour des séquences de longueurs différentes.
+ *
+ * @param part Part lue par ce rang.
+ * @param lens Rempli avec la longueur des part.n séquences.
+ * @param comm Communicateur MPI.
+ * @return Toutes les séquences à la suite, dans l'ordre du fichier.
+ *
+ * @throw std::runtime_error sur tous les rangs si le total dépasse INT_MAX caractères.
+ */
+std::vector<char> allgatherFastaVariable(const FastaPart& part, std::vector<int>& lens, MPI_Comm comm);
+
+#endif // FASTA_READER_HPP
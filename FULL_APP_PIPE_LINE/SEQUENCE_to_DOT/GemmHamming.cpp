@@ -0,0 +1,251 @@
+#define OMPI_SKIP_MPICXX 1
+#include "GemmHamming.hpp"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define GEMM_X86 1
+#endif
+
+// Ajoute les colonnes valides d'un bloc calculé sur 16 bits au résultat int32.
+static inline void addBlock(const int16_t* acc, int nr, int32_t* c, int ldc, int rows, int cols) {
+    for (int r = 0; r < rows; ++r) {
+        for (int col = 0; col < cols; ++col) {
+            c[r * ldc + col] += acc[r * nr + col];
+        }
+    }
+}
+
+// Version scalaire, 8 colonnes par bloc : même format de panneaux que les
+// versions vectorisées, pour pouvoir comparer les résultats.
+static void gemmMicroScalar(const uint16_t* a, const uint8_t* b, int kPairs,
+                            int32_t* c, int ldc, int rows, int cols)
+{
+    const int NR = 8;
+    int16_t acc[GEMM_MR * NR] = {};
+    for (int kp = 0; kp < kPairs; ++kp) {
+        const uint8_t* bk = b + (size_t)kp * 2 * NR;
+        #pragma GCC unroll 4
+        for (int r = 0; r < GEMM_MR; ++r) {
+            const int a0 = a[kp * GEMM_MR + r] & 0xFF;
+            const int a1 = a[kp * GEMM_MR + r] >> 8;
+            for (int col = 0; col < NR; ++col) {
+                acc[r * NR + col] += (int16_t)(bk[2 * col] * a0 + bk[2 * col + 1] * a1);
+            }
+        }
+    }
+    addBlock(acc, NR, c, ldc, rows, cols);
+}
+
+#ifdef GEMM_X86
+
+// Comme pour HammingKernels, chaque micro-noyau est compilé pour son jeu
+// d'instructions avec l'attribut target, et n'est appelé que si le processeur
+// le supporte. pmaddubsw multiplie les octets de b (non signés) par ceux de a
+// (signés) et additionne les produits deux par deux sur 16 bits : avec la
+// paire d'octets de la ligne diffusée dans chaque mot, une instruction fait
+// 2 valeurs de k pour nr colonnes.
+
+__attribute__((target("sse4.2")))
+static void gemmMicroSSE42(const uint16_t* a, const uint8_t* b, int kPairs,
+                           int32_t* c, int ldc, int rows, int cols)
+{
+    const int NR = 8;
+    __m128i acc[GEMM_MR];
+    #pragma GCC unroll 4
+    for (int r = 0; r < GEMM_MR; ++r) acc[r] = _mm_setzero_si128();
+    for (int kp = 0; kp < kPairs; ++kp) {
+        __m128i bv = _mm_loadu_si128((const __m128i*)(b + (size_t)kp * 2 * NR));
+        #pragma GCC unroll 4
+        for (int r = 0; r < GEMM_MR; ++r) {
+            __m128i av = _mm_set1_epi16((short)a[kp * GEMM_MR + r]);
+            acc[r] = _mm_add_epi16(acc[r], _mm_maddubs_epi16(bv, av));
+        }
+    }
+    int16_t out[GEMM_MR * NR];
+    #pragma GCC unroll 4
+    for (int r = 0; r < GEMM_MR; ++r) _mm_storeu_si128((__m128i*)(out + r * NR), acc[r]);
+    addBlock(out, NR, c, ldc, rows, cols);
+}
+
+__attribute__((target("avx2")))
+static void gemmMicroAVX2(const uint16_t* a, const uint8_t* b, int kPairs,
+                          int32_t* c, int ldc, int rows, int cols)
+{
+    const int NR = 16;
+    __m256i acc[GEMM_MR];
+    #pragma GCC unroll 4
+    for (int r = 0; r < GEMM_MR; ++r) acc[r] = _mm256_setzero_si256();
+    for (int kp = 0; kp < kPairs; ++kp) {
+        __m256i bv = _mm256_loadu_si256((const __m256i*)(b + (size_t)kp * 2 * NR));
+        #pragma GCC unroll 4
+        for (int r = 0; r < GEMM_MR; ++r) {
+            __m256i av = _mm256_set1_epi16((short)a[kp * GEMM_MR + r]);
+            acc[r] = _mm256_add_epi16(acc[r], _mm256_maddubs_epi16(bv, av));
+        }
+    }
+    int16_t out[GEMM_MR * NR];
+    #pragma GCC unroll 4
+    for (int r = 0; r < GEMM_MR; ++r) _mm256_storeu_si256((__m256i*)(out + r * NR), acc[r]);
+    addBlock(out, NR, c, ldc, rows, cols);
+}
+
+__attribute__((target("avx512f,avx512bw")))
+static void gemmMicroAVX512(const uint16_t* a, const uint8_t* b, int kPairs,
+                            int32_t* c, int ldc, int rows, int cols)
+{
+    const int NR = 32;
+    __m512i acc[GEMM_MR];
+    #pragma GCC unroll 4
+    for (int r = 0; r < GEMM_MR; ++r) acc[r] = _mm512_setzero_si512();
+    for (int kp = 0; kp < kPairs; ++kp) {
+        __m512i bv = _mm512_loadu_si512((const void*)(b + (size_t)kp * 2 * NR));
+        #pragma GCC unroll 4
+        for (int r = 0; r < GEMM_MR; ++r) {
+            __m512i av = _mm512_set1_epi16((short)a[kp * GEMM_MR + r]);
+            acc[r] = _mm512_add_epi16(acc[r], _mm512_maddubs_epi16(bv, av));
+        }
+    }
+    int16_t out[GEMM_MR * NR];
+    #pragma GCC unroll 4
+    for (int r = 0; r < GEMM_MR; ++r) _mm512_storeu_si512((void*)(out + r * NR), acc[r]);
+    addBlock(out, NR, c, ldc, rows, cols);
+}
+
+#endif // GEMM_X86
+
+static GemmKernel gemmKernelFor(SimdLevel level) {
+    switch (level) {
+#ifdef GEMM_X86
+        case SimdLevel::SSE42:  return {gemmMicroSSE42,  8,  "sse4.2"};
+        case SimdLevel::AVX2:   return {gemmMicroAVX2,   16, "avx2"};
+        case SimdLevel::AVX512: return {gemmMicroAVX512, 32, "avx512bw"};
+#endif
+        default:                return {gemmMicroScalar, 8,  "scalar"};
+    }
+}
+
+GemmKernel selectGemmKernel(SimdLevel wanted) {
+    if (wanted == SimdLevel::Auto) {
+        const SimdLevel order[] = {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE42};
+        for (SimdLevel level : order) {
+            if (cpuSupportsSimd(level)) return gemmKernelFor(level);
+        }
+        return gemmKernelFor(SimdLevel::Scalar);
+    }
+
+    if (!cpuSupportsSimd(wanted)) {
+        throw std::runtime_error(std::string("Jeu d'instructions non supporte par ce processeur : ")
+                                 + gemmKernelFor(wanted).name);
+    }
+    return gemmKernelFor(wanted);
+}
+
+// Appelle f(q, code) pour chaque base p0 + q (0 <= q < nb) de la séquence i,
+// sauf les exceptions : leur one-hot reste nul. Dans le one-hot, la base q
+// a son 1 à l'octet k = 4q + code, c'est-à-dire dans la paire kp = 2q + code / 2.
+template <typename F>
+static inline void forEachCode(const PackedSeqs& ps, int i, int p0, int nb, F&& f) {
+    const uint64_t* seq = &ps.codes[(size_t)i * ps.words];
+    const int* exc = ps.excPos.data() + ps.excOffset[i];
+    const int* excEnd = ps.excPos.data() + ps.excOffset[i + 1];
+    exc = std::lower_bound(exc, excEnd, p0);
+
+    for (int p = p0; p < p0 + nb; ++p) {
+        if (exc != excEnd && *exc == p) {
+            ++exc;
+            continue;
+        }
+        f(p - p0, (int)((seq[p >> 5] >> (2 * (p & 31))) & 3ULL));
+    }
+}
+
+// Positions où i et j ont toutes les deux une exception, avec le même
+// caractère : elles sont égales, mais leur one-hot nul ne les a pas comptées.
+static int exceptionMatches(const PackedSeqs& ps, int i, int j) {
+    int pa = ps.excOffset[i], ea = ps.excOffset[i + 1];
+    int pb = ps.excOffset[j], eb = ps.excOffset[j + 1];
+    int same = 0;
+    while (pa < ea && pb < eb) {
+        if (ps.excPos[pa] < ps.excPos[pb]) {
+            ++pa;
+        } else if (ps.excPos[pb] < ps.excPos[pa]) {
+            ++pb;
+        } else {
+            same += (ps.excChar[pa++] == ps.excChar[pb++]) ? 1 : 0;
+        }
+    }
+    return same;
+}
+
+void gemmTileDistances(const PackedSeqs& ps, const Tile& t, const GemmKernel& k,
+                       std::vector<int>& dist)
+{
+    const int rows = t.i1 - t.i0;
+    const int cols = t.j1 - t.j0;
+    const int NR = k.nr;
+    const int rowBlocks = (rows + GEMM_MR - 1) / GEMM_MR;
+    const int colBlocks = (cols + NR - 1) / NR;
+
+    // Tampons de chaque thread, gardés d'une tuile à l'autre
+    thread_local std::vector<int32_t> matches;
+    thread_local std::vector<uint16_t> aPanel;
+    thread_local std::vector<uint8_t> bPanel;
+
+    matches.assign((size_t)rows * cols, 0);
+
+    for (int p0 = 0; p0 < ps.L; p0 += GEMM_KC_BASES) {
+        const int nb = std::min(GEMM_KC_BASES, ps.L - p0);
+        const int kPairs = 2 * nb;   // 4 octets par base, pris deux par deux
+
+        // Panneau des colonnes : pour chaque bloc de NR colonnes, les paires
+        // d'octets de k rangées colonne après colonne (une ligne de registre par kp).
+        // Les panneaux sont remis à 0, puis on n'écrit que les 1 du one-hot.
+        bPanel.assign((size_t)colBlocks * kPairs * 2 * NR, 0);
+        for (int col = 0; col < cols; ++col) {
+            uint8_t* dst = &bPanel[(size_t)(col / NR) * kPairs * 2 * NR + 2 * (col % NR)];
+            forEachCode(ps, t.j0 + col, p0, nb, [&](int q, int code) {
+                dst[(size_t)(2 * q + (code >> 1)) * 2 * NR + (code & 1)] = 1;
+            });
+        }
+
+        // Panneau des lignes : la paire d'octets de chaque ligne dans un mot de 16 bits
+        aPanel.assign((size_t)rowBlocks * kPairs * GEMM_MR, 0);
+        for (int row = 0; row < rows; ++row) {
+            uint16_t* dst = &aPanel[(size_t)(row / GEMM_MR) * kPairs * GEMM_MR + (row % GEMM_MR)];
+            forEachCode(ps, t.i0 + row, p0, nb, [&](int q, int code) {
+                dst[(size_t)(2 * q + (code >> 1)) * GEMM_MR] = (uint16_t)(1 << (8 * (code & 1)));
+            });
+        }
+
+        for (int rb = 0; rb < rowBlocks; ++rb) {
+            const int r0 = rb * GEMM_MR;
+            const int nRows = std::min(GEMM_MR, rows - r0);
+            for (int cb = 0; cb < colBlocks; ++cb) {
+                const int c0 = cb * NR;
+                const int nCols = std::min(NR, cols - c0);
+                // Bloc entièrement sous la diagonale (aucune paire i < j) : inutile
+                if (t.j0 + c0 + nCols - 1 <= t.i0 + r0) continue;
+                k.micro(&aPanel[(size_t)rb * kPairs * GEMM_MR],
+                        &bPanel[(size_t)cb * kPairs * 2 * NR],
+                        kPairs, &matches[(size_t)r0 * cols + c0], cols, nRows, nCols);
+            }
+        }
+    }
+
+    dist.resize((size_t)rows * cols);
+    for (int row = 0; row < rows; ++row) {
+        const int i = t.i0 + row;
+        const bool excI = ps.excOffset[i + 1] > ps.excOffset[i];
+        for (int col = 0; col < cols; ++col) {
+            const int j = t.j0 + col;
+            int same = matches[(size_t)row * cols + col];
+            if (excI && ps.excOffset[j + 1] > ps.excOffset[j]) {
+                same += exceptionMatches(ps, i, j);
+            }
+            dist[(size_t)row * cols + col] = ps.L - same;
+        }
+    }
+}
@@ -0,0 +1,86 @@
+#ifndef GEMM_HAMMING_HPP
+#define GEMM_HAMMING_HPP
+
+#include <cstdint>
+#include <vector>
+#include "HammingKernels.hpp"
+#include "PackedSeqs.hpp"
+#include "Tiles.hpp"
+
+/**
+ * @file GemmHamming.hpp
+ * @brief Distance de Hamming calculée comme un produit de matrices (--kernel=gemm).
+ *
+ * Chaque séquence est codée en "one-hot" : la base en position p devient 4
+ * octets (1 pour la base, 0 pour les 3 autres), soit un vecteur de 4L octets.
+ * Le nombre de positions égales entre i et j est alors le produit scalaire de
+ * leurs deux vecteurs, et pour une tuile de lignes X_I et de colonnes X_J toutes
+ * les correspondances sont données par le produit X_I · X_Jᵀ (somme des
+ * X_c · X_cᵀ sur les 4 bases c). La distance vaut L - correspondances.
+ *
+ * Le produit est organisé comme un GEMM classique : la dimension k (les 4L
+ * octets) est découpée en morceaux de GEMM_KC_BASES bases, et pour chaque
+ * morceau les séquences de la tuile sont recopiées en one-hot dans deux
+ * panneaux (lignes par groupes de GEMM_MR, colonnes par groupes de nr) rangés
+ * dans l'ordre où le micro-noyau les lit. Le micro-noyau multiplie des octets
+ * 0 / 1 deux par deux (pmaddubsw) et accumule sur 16 bits un bloc GEMM_MR × nr
+ * de la tuile, sans aucun branchement : le calcul ne dépend que du débit des
+ * unités vectorielles.
+ *
+ * Le one-hot est fabriqué à la volée depuis PackedSeqs, morceau par morceau :
+ * il n'existe jamais en entier en mémoire (il est 16 fois plus gros que le
+ * codage 2 bits). Les exceptions (bases hors alphabet) ont un one-hot nul et
+ * sont recomparées à la fin avec leurs caractères d'origine.
+ */
+
+/** Lignes d'un bloc du micro-noyau. */
+const int GEMM_MR = 4;
+
+/** Bases par morceau de k (la somme d'un morceau tient largement sur 16 bits). */
+const int GEMM_KC_BASES = 256;
+
+/**
+ * @brief Micro-noyau : ajoute à c un bloc GEMM_MR × nr de correspondances.
+ *
+ * @param a      Panneau de lignes : a[kp * GEMM_MR + r] contient les octets
+ *               2kp (poids faible) et 2kp + 1 (poids fort) de la ligne r.
+ * @param b      Panneau de colonnes : b[(kp * nr + c) * 2 + {0, 1}] = octets
+ *               2kp et 2kp + 1 de la colonne c.
+ * @param kPairs Nombre de paires d'octets du morceau.
+ * @param c      Bloc de sortie (int32), c[r * ldc + col].
+ * @param rows   Lignes valides du bloc (<= GEMM_MR).
+ * @param cols   Colonnes valides du bloc (<= nr).
+ */
+typedef void (*GemmMicroFn)(const uint16_t* a, const uint8_t* b, int kPairs,
+                            int32_t* c, int ldc, int rows, int cols);
+
+/**
+ * @struct GemmKernel
+ * @brief Micro-noyau retenu, avec sa largeur et son nom.
+ */
+struct GemmKernel {
+    GemmMicroFn micro;   /**< Fonction à appeler. */
+    int nr;              /**< Colonnes par bloc (une largeur de registre en int16). */
+    const char* name;    /**< Nom lisible ("scalar", "sse4.2", "avx2", "avx512bw"). */
+};
+
+/**
+ * @brief Choisit le micro-noyau GEMM d'après le processeur (comme selectHammingKernel).
+ *
+ * @throw std::runtime_error si le jeu demandé n'est pas supporté par ce processeur.
+ */
+GemmKernel selectGemmKernel(SimdLevel wanted);
+
+/**
+ * @brief Distances de Hamming de toutes les paires d'une tuile, par produit de matrices.
+ *
+ * @param ps   Séquences codées sur 2 bits.
+ * @param t    Tuile à calculer.
+ * @param k    Micro-noyau (voir selectGemmKernel).
+ * @param dist Sortie : dist[(i - t.i0) * (t.j1 - t.j0) + (j - t.j0)] = d(i, j)
+ *             pour chaque paire i < j de la tuile (les autres cases ne servent pas).
+ */
+void gemmTileDistances(const PackedSeqs& ps, const Tile& t, const GemmKernel& k,
+                       std::vector<int>& dist);
+
+#endif // GEMM_HAMMING_HPP
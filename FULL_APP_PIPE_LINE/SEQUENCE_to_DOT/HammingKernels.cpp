@@ -0,0 +1,181 @@
+#include "HammingKernels.hpp"
+#include <stdexcept>
+#include <string>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define HAMMING_X86 1
+#endif
+
+int hammingScalar(const char* a, const char* b, int L) {
+    int d = 0;
+    for (int i = 0; i < L; ++i) {
+        if (a[i] != b[i]) ++d;
+    }
+    return d;
+}
+
+int hammingScalarBounded(const char* a, const char* b, int L, int bound) {
+    int d = 0;
+    int i = 0;
+    // Je teste la borne tous les 32 caractères seulement,
+    // pour ne pas ajouter un test à chaque comparaison.
+    for (; i + 32 <= L; i += 32) {
+        for (int k = i; k < i + 32; ++k) {
+            if (a[k] != b[k]) ++d;
+        }
+        if (d >= bound) return bound;
+    }
+    for (; i < L; ++i) {
+        if (a[i] != b[i]) ++d;
+    }
+    return d < bound ? d : bound;
+}
+
+#ifdef HAMMING_X86
+
+// Chaque noyau est compilé pour son jeu d'instructions avec l'attribut target :
+// pas besoin de -mavx2 etc. pour tout le programme, et le code ne sera exécuté
+// que si selectHammingKernel a vérifié que le processeur le supporte.
+//
+// Chaque noyau est écrit une seule fois avec un paramètre BOUNDED : la version
+// bornée s'arrête dès que le compte atteint bound et renvoie bound (saturation),
+// la version normale compile sans ce test.
+
+// SSE4.2 : 16 caractères par tour. cmpeq met 0xFF sur les octets égaux,
+// movemask en fait un masque de 16 bits, et je compte les égalités.
+template <bool BOUNDED>
+__attribute__((target("sse4.2,popcnt")))
+static inline int hammingSSE42Impl(const char* a, const char* b, int L, int bound) {
+    int d = 0;
+    int i = 0;
+    for (; i + 16 <= L; i += 16) {
+        __m128i va = _mm_loadu_si128((const __m128i*)(a + i));
+        __m128i vb = _mm_loadu_si128((const __m128i*)(b + i));
+        unsigned eq = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(va, vb));
+        d += 16 - _mm_popcnt_u32(eq);
+        if (BOUNDED && d >= bound) return bound;
+    }
+    // Reste (moins de 16 caractères) en scalaire
+    for (; i < L; ++i) {
+        if (a[i] != b[i]) ++d;
+    }
+    return (BOUNDED && d > bound) ? bound : d;
+}
+
+// AVX2 : même principe sur 32 caractères.
+template <bool BOUNDED>
+__attribute__((target("avx2,popcnt")))
+static inline int hammingAVX2Impl(const char* a, const char* b, int L, int bound) {
+    int d = 0;
+    int i = 0;
+    for (; i + 32 <= L; i += 32) {
+        __m256i va = _mm256_loadu_si256((const __m256i*)(a + i));
+        __m256i vb = _mm256_loadu_si256((const __m256i*)(b + i));
+        unsigned eq = (unsigned)_mm256_movemask_epi8(_mm256_cmpeq_epi8(va, vb));
+        d += 32 - _mm_popcnt_u32(eq);
+        if (BOUNDED && d >= bound) return bound;
+    }
+    for (; i < L; ++i) {
+        if (a[i] != b[i]) ++d;
+    }
+    return (BOUNDED && d > bound) ? bound : d;
+}
+
+// AVX-512BW : la comparaison donne directement un masque de 64 bits
+// (un bit par octet différent). Le reste est traité avec un chargement masqué,
+// donc pas de boucle scalaire à la fin.
+template <bool BOUNDED>
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static inline int hammingAVX512Impl(const char* a, const char* b, int L, int bound) {
+    long long d = 0;
+    int i = 0;
+    for (; i + 64 <= L; i += 64) {
+        __m512i va = _mm512_loadu_si512((const void*)(a + i));
+        __m512i vb = _mm512_loadu_si512((const void*)(b + i));
+        d += _mm_popcnt_u64(_mm512_cmpneq_epi8_mask(va, vb));
+        if (BOUNDED && d >= bound) return bound;
+    }
+    if (i < L) {
+        __mmask64 tail = (~0ULL) >> (64 - (L - i));
+        __m512i va = _mm512_maskz_loadu_epi8(tail, a + i);
+        __m512i vb = _mm512_maskz_loadu_epi8(tail, b + i);
+        d += _mm_popcnt_u64(_mm512_mask_cmpneq_epi8_mask(tail, va, vb));
+    }
+    return (BOUNDED && d > bound) ? bound : (int)d;
+}
+
+__attribute__((target("sse4.2,popcnt")))
+static int hammingSSE42(const char* a, const char* b, int L) {
+    return hammingSSE42Impl<false>(a, b, L, 0);
+}
+__attribute__((target("sse4.2,popcnt")))
+static int hammingSSE42Bounded(const char* a, const char* b, int L, int bound) {
+    return hammingSSE42Impl<true>(a, b, L, bound);
+}
+__attribute__((target("avx2,popcnt")))
+static int hammingAVX2(const char* a, const char* b, int L) {
+    return hammingAVX2Impl<false>(a, b, L, 0);
+}
+__attribute__((target("avx2,popcnt")))
+static int hammingAVX2Bounded(const char* a, const char* b, int L, int bound) {
+    return hammingAVX2Impl<true>(a, b, L, bound);
+}
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static int hammingAVX512(const char* a, const char* b, int L) {
+    return hammingAVX512Impl<false>(a, b, L, 0);
+}
+__attribute__((target("avx512f,avx512bw,popcnt")))
+static int hammingAVX512Bounded(const char* a, const char* b, int L, int bound) {
+    return hammingAVX512Impl<true>(a, b, L, bound);
+}
+
+#endif // HAMMING_X86
+
+// Le processeur courant supporte-t-il ce jeu d'instructions ?
+bool cpuSupportsSimd(SimdLevel level) {
+#ifdef HAMMING_X86
+    __builtin_cpu_init();
+    switch (level) {
+        case SimdLevel::SSE42:
+            return __builtin_cpu_supports("sse4.2") && __builtin_cpu_supports("popcnt");
+        case SimdLevel::AVX2:
+            return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("popcnt");
+        case SimdLevel::AVX512:
+            return __builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")
+                && __builtin_cpu_supports("popcnt");
+        default:
+            return true;
+    }
+#else
+    return level == SimdLevel::Scalar || level == SimdLevel::Auto;
+#endif
+}
+
+static HammingKernel kernelFor(SimdLevel level) {
+    switch (level) {
+#ifdef HAMMING_X86
+        case SimdLevel::SSE42:  return {hammingSSE42,  hammingSSE42Bounded,  "sse4.2"};
+        case SimdLevel::AVX2:   return {hammingAVX2,   hammingAVX2Bounded,   "avx2"};
+        case SimdLevel::AVX512: return {hammingAVX512, hammingAVX512Bounded, "avx512bw"};
+#endif
+        default:                return {hammingScalar, hammingScalarBounded, "scalar"};
+    }
+}
+
+HammingKernel selectHammingKernel(SimdLevel wanted) {
+    if (wanted == SimdLevel::Auto) {
+        // Du plus large au plus simple : on garde le premier supporté
+        const SimdLevel order[] = {SimdLevel::AVX512, SimdLevel::AVX2, SimdLevel::SSE42};
+        for (SimdLevel level : order) {
+            if (cpuSupportsSimd(level)) return kernelFor(level);
+        }
+        return kernelFor(SimdLevel::Scalar);
+    }
+
+    if (!cpuSupportsSimd(wanted)) {
+        throw std::runtime_error(std::string("Jeu d'instructions non supporte par ce processeur : ")
+                                 + kernelFor(wanted).name);
+    }
+    return kernelFor(wanted);
+}
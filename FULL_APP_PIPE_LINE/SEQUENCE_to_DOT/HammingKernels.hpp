@@ -0,0 +1,86 @@
+#ifndef HAMMING_KERNELS_HPP
+#define HAMMING_KERNELS_HPP
+
+/**
+ * @file HammingKernels.hpp
+ * @brief Noyaux de distance de Hamming sur tableaux de caractères,
+ *        en version scalaire et vectorisée (SSE4.2, AVX2, AVX-512BW).
+ *
+ * Les versions vectorisées comparent 16, 32 ou 64 caractères d'un coup
+ * (cmpeq + movemask, ou directement un masque en AVX-512) puis comptent
+ * les différences avec popcnt. Chaque noyau existe aussi en version bornée,
+ * qui s'arrête dès que la distance atteint un seuil donné.
+ *
+ * Le choix du noyau se fait à l'exécution, d'après les instructions
+ * supportées par le processeur (CPUID) : le même exécutable prend donc
+ * le meilleur noyau disponible sur chaque nœud, même si les nœuds du
+ * cluster ne sont pas de la même génération.
+ */
+
+/**
+ * @brief Signature commune des noyaux : distance entre a et b de longueur L.
+ */
+typedef int (*HammingFn)(const char* a, const char* b, int L);
+
+/**
+ * @brief Signature des noyaux bornés : même calcul, mais on s'arrête dès que
+ *        la distance atteint bound, et on renvoie alors bound (valeur saturée).
+ *
+ * Le résultat vaut donc min(distance(a, b), bound). C'est suffisant pour le
+ * graphe epsilon, qui ne garde que les paires avec d < epsilon.
+ */
+typedef int (*HammingBoundedFn)(const char* a, const char* b, int L, int bound);
+
+/**
+ * @brief Jeu d'instructions demandé pour le noyau caractère.
+ */
+enum class SimdLevel {
+    Auto,     /**< Le meilleur noyau supporté par le processeur. */
+    Scalar,   /**< Boucle simple, disponible partout. */
+    SSE42,    /**< 16 caractères par itération. */
+    AVX2,     /**< 32 caractères par itération. */
+    AVX512    /**< 64 caractères par itération (AVX-512BW). */
+};
+
+/**
+ * @struct HammingKernel
+ * @brief Noyau retenu : pointeur de fonction + nom pour l'affichage.
+ */
+struct HammingKernel {
+    HammingFn fn;               /**< Fonction à appeler. */
+    HammingBoundedFn bounded;   /**< Version bornée (arrêt anticipé) du même noyau. */
+    const char* name;           /**< Nom lisible ("scalar", "sse4.2", "avx2", "avx512bw"). */
+};
+
+/**
+ * @brief Distance de Hamming, version scalaire (un caractère à la fois).
+ */
+int hammingScalar(const char* a, const char* b, int L);
+
+/**
+ * @brief Distance de Hamming bornée, version scalaire.
+ *
+ * La borne est testée tous les 32 caractères.
+ *
+ * @return min(distance(a, b), bound).
+ */
+int hammingScalarBounded(const char* a, const char* b, int L, int bound);
+
+/**
+ * @brief Vrai si le processeur courant supporte le jeu d'instructions level
+ *        (toujours vrai pour Scalar et Auto).
+ */
+bool cpuSupportsSimd(SimdLevel level);
+
+/**
+ * @brief Choisit le noyau de Hamming à utiliser sur ce processus.
+ *
+ * @param wanted Jeu d'instructions demandé. Avec SimdLevel::Auto, on prend
+ *               le plus large supporté par le processeur.
+ * @return Le noyau correspondant.
+ *
+ * @throw std::runtime_error si le jeu demandé n'est pas supporté par ce processeur.
+ */
+HammingKernel selectHammingKernel(SimdLevel wanted);
+
+#endif // HAMMING_KERNELS_HPP
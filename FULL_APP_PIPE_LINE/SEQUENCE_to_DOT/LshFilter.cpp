@@ -0,0 +1,52 @@
+#include "LshFilter.hpp"
+#include <algorithm>
+#include <numeric>
+#include <random>
+
+std::vector<int> lshPositions(int L, int bands, int rows, uint64_t seed) {
+    std::mt19937_64 rng(seed);
+    std::vector<int> all(L);
+    std::vector<int> positions;
+    positions.reserve((std::size_t)bands * rows);
+
+    for (int b = 0; b < bands; ++b) {
+        // Début d'un mélange de Fisher-Yates : les rows premières cases
+        // donnent rows positions distinctes.
+        std::iota(all.begin(), all.end(), 0);
+        for (int r = 0; r < rows; ++r) {
+            std::uniform_int_distribution<int> pick(r, L - 1);
+            std::swap(all[r], all[pick(rng)]);
+            positions.push_back(all[r]);
+        }
+    }
+    return positions;
+}
+
+LshCandidates buildLshCandidates(std::vector<uint64_t> sig, int n, int bands) {
+    LshCandidates c;
+    c.n = n;
+    c.bands = bands;
+    c.sig.swap(sig);
+    c.order.resize((std::size_t)bands * n);
+
+    for (int b = 0; b < bands; ++b) {
+        int* order = &c.order[(std::size_t)b * n];
+        const uint64_t* s = &c.sig[(std::size_t)b * n];
+        std::iota(order, order + n, 0);
+        std::sort(order, order + n, [s](int x, int y) {
+            return s[x] != s[y] ? s[x] < s[y] : x < y;
+        });
+
+        // Chaque seau de s séquences donne s - 1 lignes (la dernière séquence
+        // n'a plus personne après elle).
+        std::size_t start = 0;
+        for (std::size_t k = 1; k <= (std::size_t)n; ++k) {
+            if (k < (std::size_t)n && s[order[k]] == s[order[start]]) continue;
+            for (std::size_t f = start; f + 1 < k; ++f) {
+                c.rows.push_back({b, f, k});
+            }
+            start = k;
+        }
+    }
+    return c;
+}
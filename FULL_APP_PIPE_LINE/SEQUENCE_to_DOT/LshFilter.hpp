@@ -0,0 +1,117 @@
+#ifndef LSH_FILTER_HPP
+#define LSH_FILTER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file LshFilter.hpp
+ * @brief Présélection des paires à comparer par LSH "bit sampling" (distance de Hamming).
+ *
+ * Au lieu de calculer les n(n-1)/2 distances, on tire B bandes de R positions
+ * au hasard (les mêmes sur tous les rangs). La signature d'une séquence dans
+ * une bande est la suite de ses R bases à ces positions. Deux séquences ne sont
+ * candidates que si elles ont la même signature dans au moins une bande ;
+ * seules les paires candidates sont ensuite vérifiées avec le noyau exact.
+ *
+ * Pour deux séquences de longueur L à distance d, une bande est identique avec
+ * la probabilité (1 - d/L)^R, donc la paire est candidate avec la probabilité
+ * 1 - (1 - (1 - d/L)^R)^B. Plus R est grand, moins il y a de candidats
+ * éloignés ; plus B est grand, moins on rate de paires proches. Les arêtes
+ * trouvées sont exactes, mais certaines peuvent manquer (rappel < 1).
+ */
+
+/**
+ * @struct LshRow
+ * @brief Une "ligne" de candidats : la séquence order[first] d'un seau, contre
+ *        les séquences suivantes du même seau order[first + 1 .. end).
+ */
+struct LshRow {
+    int band;            /**< Bande du seau. */
+    std::size_t first;   /**< Position de la séquence dans order. */
+    std::size_t end;     /**< Fin du seau dans order (exclue). */
+};
+
+/**
+ * @struct LshCandidates
+ * @brief Signatures et seaux de toutes les bandes.
+ *
+ * Dans la bande b, order[b * n .. (b + 1) * n) contient les indices des
+ * séquences triés par signature : un seau est une suite de signatures égales.
+ */
+struct LshCandidates {
+    int n = 0;                  /**< Nombre de séquences. */
+    int bands = 0;              /**< Nombre de bandes B. */
+    std::vector<uint64_t> sig;  /**< sig[b * n + i] : signature de la séquence i dans la bande b. */
+    std::vector<int> order;     /**< Séquences triées par signature, bande par bande. */
+    std::vector<LshRow> rows;   /**< Toutes les lignes des seaux d'au moins 2 séquences. */
+};
+
+/**
+ * @brief Tire les positions des bandes : R positions distinctes par bande.
+ *
+ * Le tirage ne dépend que de (L, bands, rows, seed), il est donc identique sur
+ * tous les rangs sans communication.
+ *
+ * @return positions[b * rows + r] = r-ième position de la bande b.
+ */
+std::vector<int> lshPositions(int L, int bands, int rows, uint64_t seed);
+
+/**
+ * @brief Calcule les signatures de n séquences.
+ *
+ * @param baseAt baseAt(i, p) renvoie la base en position p de la séquence i.
+ * @return sig[b * n + i], un hachage des R bases de la séquence i dans la bande b.
+ */
+template <typename F>
+std::vector<uint64_t> lshSignatures(int n, const std::vector<int>& positions,
+                                    int bands, int rows, F&& baseAt)
+{
+    std::vector<uint64_t> sig((std::size_t)bands * n);
+    for (int b = 0; b < bands; ++b) {
+        const int* pos = &positions[(std::size_t)b * rows];
+        for (int i = 0; i < n; ++i) {
+            uint64_t h = 0xcbf29ce484222325ULL;   // FNV-1a
+            for (int r = 0; r < rows; ++r) {
+                h ^= (unsigned char)baseAt(i, pos[r]);
+                h *= 0x100000001b3ULL;
+            }
+            sig[(std::size_t)b * n + i] = h;
+        }
+    }
+    return sig;
+}
+
+/**
+ * @brief Range les séquences en seaux (signatures égales) dans chaque bande.
+ *
+ * @param sig   Signatures (voir lshSignatures), déplacées dans le résultat.
+ * @param n     Nombre de séquences.
+ * @param bands Nombre de bandes.
+ */
+LshCandidates buildLshCandidates(std::vector<uint64_t> sig, int n, int bands);
+
+/**
+ * @brief Applique f(i, j), i < j, à chaque paire candidate d'une ligne.
+ *
+ * Une paire qui partage aussi un seau dans une bande précédente est sautée :
+ * elle y a déjà été (ou y sera) proposée, chaque paire n'est vérifiée qu'une fois.
+ */
+template <typename F>
+inline void forEachCandidate(const LshCandidates& c, const LshRow& row, F&& f) {
+    const int* order = &c.order[(std::size_t)row.band * c.n];
+    const int a = order[row.first];
+    for (std::size_t t = row.first + 1; t < row.end; ++t) {
+        const int b = order[t];
+        bool seen = false;
+        for (int e = 0; e < row.band && !seen; ++e) {
+            seen = (c.sig[(std::size_t)e * c.n + a] == c.sig[(std::size_t)e * c.n + b]);
+        }
+        if (seen) continue;
+        if (a < b) f(a, b);
+        else       f(b, a);
+    }
+}
+
+#endif // LSH_FILTER_HPP
@@ -0,0 +1,195 @@
+#include "Options.hpp"
+#include <algorithm>
+#include <stdexcept>
+
+// Si arg commence par "--name=", je mets la valeur dans value et je renvoie true.
+static bool matchOption(const std::string& arg, const std::string& name, std::string& value) {
+    const std::string prefix = "--" + name + "=";
+    if (arg.compare(0, prefix.size(), prefix) != 0) return false;
+    value = arg.substr(prefix.size());
+    return true;
+}
+
+// Convertit value en entier >= minValue, sinon erreur sur l'option --name.
+static int parseIntAtLeast(const std::string& value, const std::string& name, int minValue) {
+    size_t used = 0;
+    int v = 0;
+    try {
+        v = std::stoi(value, &used);
+    } catch (const std::exception&) {
+        used = 0;
+    }
+    if (value.empty() || used != value.size() || v < minValue) {
+        throw std::runtime_error("Valeur invalide pour --" + name + " : " + value);
+    }
+    return v;
+}
+
+BuildOptions parseOptions(int argc, char** argv) {
+    BuildOptions opt;
+
+    for (int a = 1; a < argc; ++a) {
+        const std::string arg = argv[a];
+        std::string value;
+
+        if (matchOption(arg, "distance", value)) {
+            if (value == "hamming")   opt.distance = Distance::Hamming;
+            else if (value == "edit") opt.distance = Distance::Edit;
+            else if (value == "weighted") opt.distance = Distance::Weighted;
+            else throw std::runtime_error("Distance inconnue : " + value);
+        } else if (matchOption(arg, "kernel", value)) {
+            if (value == "packed")    opt.kernel = Kernel::Packed;
+            else if (value == "char") opt.kernel = Kernel::Char;
+            else if (value == "gemm") opt.kernel = Kernel::Gemm;
+            else throw std::runtime_error("Noyau inconnu : " + value);
+        } else if (matchOption(arg, "simd", value)) {
+            if (value == "auto")        opt.simd = SimdLevel::Auto;
+            else if (value == "scalar") opt.simd = SimdLevel::Scalar;
+            else if (value == "sse4.2") opt.simd = SimdLevel::SSE42;
+            else if (value == "avx2")   opt.simd = SimdLevel::AVX2;
+            else if (value == "avx512") opt.simd = SimdLevel::AVX512;
+            else throw std::runtime_error("Jeu d'instructions inconnu : " + value);
+        } else if (matchOption(arg, "reader", value)) {
+            if (value == "parallel")   opt.reader = Reader::Parallel;
+            else if (value == "rank0") opt.reader = Reader::Rank0;
+            else throw std::runtime_error("Lecteur inconnu : " + value);
+        } else if (matchOption(arg, "writer", value)) {
+            if (value == "parallel")   opt.writer = Writer::Parallel;
+            else if (value == "rank0") opt.writer = Writer::Rank0;
+            else throw std::runtime_error("Ecriture inconnue : " + value);
+        } else if (matchOption(arg, "schedule", value)) {
+            if (value == "dynamic")     opt.schedule = Schedule::Dynamic;
+            else if (value == "static") opt.schedule = Schedule::Static;
+            else throw std::runtime_error("Repartition inconnue : " + value);
+        } else if (matchOption(arg, "tile", value)) {
+            opt.tile = parseIntAtLeast(value, "tile", 0);
+        } else if (matchOption(arg, "lsh", value)) {
+            // Deux entiers séparés par une virgule : bandes, positions par bande
+            size_t comma = value.find(',');
+            if (comma == std::string::npos) {
+                throw std::runtime_error("Valeur invalide pour --lsh (attendu B,R) : " + value);
+            }
+            opt.lshBands = parseIntAtLeast(value.substr(0, comma), "lsh", 1);
+            opt.lshRows = parseIntAtLeast(value.substr(comma + 1), "lsh", 1);
+        } else if (matchOption(arg, "append", value)) {
+            opt.appendFile = value;
+        } else if (matchOption(arg, "save-edges", value)) {
+            opt.saveEdgesFile = value;
+        } else if (matchOption(arg, "dedup", value)) {
+            opt.dedupFile = value;
+        } else if (matchOption(arg, "csr", value)) {
+            opt.csrFile = value;
+        } else if (arg == "--no-dot") {
+            opt.writeDot = false;
+        } else if (matchOption(arg, "epsilon", value)) {
+            // Liste de seuils séparés par des virgules
+            opt.epsilons.clear();
+            size_t start = 0;
+            while (true) {
+                size_t comma = value.find(',', start);
+                opt.epsilons.push_back(parseIntAtLeast(value.substr(start, comma - start), "epsilon", 1));
+                if (comma == std::string::npos) break;
+                start = comma + 1;
+            }
+            std::sort(opt.epsilons.begin(), opt.epsilons.end());
+            opt.epsilons.erase(std::unique(opt.epsilons.begin(), opt.epsilons.end()), opt.epsilons.end());
+        } else if (matchOption(arg, "tagged-edges", value)) {
+            opt.taggedEdgesFile = value;
+        } else if (matchOption(arg, "ts-tv", value)) {
+            size_t comma = value.find(',');
+            if (comma == std::string::npos) {
+                throw std::runtime_error("Valeur invalide pour --ts-tv (attendu TS,TV) : " + value);
+            }
+            opt.transitionCost = parseIntAtLeast(value.substr(0, comma), "ts-tv", 0);
+            opt.transversionCost = parseIntAtLeast(value.substr(comma + 1), "ts-tv", 0);
+        } else if (matchOption(arg, "position-weights", value)) {
+            opt.positionWeightsFile = value;
+        } else if (arg == "--lsh-check") {
+            opt.lshCheck = true;
+        } else if (matchOption(arg, "threads", value)) {
+            opt.threads = parseIntAtLeast(value, "threads", 0);
+        } else if (arg == "--ring") {
+            opt.ring = true;
+        } else if (arg == "--bounded") {
+            opt.bounded = true;
+        } else if (arg.compare(0, 2, "--") == 0) {
+            throw std::runtime_error("Option inconnue : " + arg);
+        } else if (opt.fastaFile.empty()) {
+            opt.fastaFile = arg;
+        } else {
+            throw std::runtime_error("Argument en trop : " + arg);
+        }
+    }
+
+    if (opt.fastaFile.empty()) {
+        throw std::runtime_error("Fichier FASTA manquant");
+    }
+    if (opt.lshBands > 0 && opt.distance != Distance::Hamming) {
+        throw std::runtime_error("--lsh ne fonctionne qu'avec la distance de Hamming");
+    }
+    if (opt.distance != Distance::Weighted
+        && (!opt.positionWeightsFile.empty() || opt.transitionCost != 1 || opt.transversionCost != 2)) {
+        throw std::runtime_error("--ts-tv et --position-weights demandent --distance=weighted");
+    }
+    if (opt.ring) {
+        // L'anneau fait circuler les blocs codés sur 2 bits, lus par chaque rang,
+        // et aucun rang n'a toutes les séquences.
+        if (opt.distance == Distance::Edit || (opt.distance == Distance::Hamming && opt.kernel == Kernel::Char)) {
+            throw std::runtime_error("--ring demande le codage 2 bits (--kernel=packed|gemm ou --distance=weighted)");
+        }
+        if (opt.reader != Reader::Parallel) {
+            throw std::runtime_error("--ring demande --reader=parallel");
+        }
+        if (opt.lshBands > 0 || !opt.appendFile.empty() || !opt.saveEdgesFile.empty() || !opt.dedupFile.empty()) {
+            throw std::runtime_error("--ring ne fonctionne pas avec --lsh, --append, --save-edges ni --dedup");
+        }
+    }
+    if (!opt.writeDot && opt.csrFile.empty()) {
+        throw std::runtime_error("--no-dot demande --csr=F (sinon aucun graphe n'est ecrit)");
+    }
+    if (opt.lshCheck && opt.lshBands == 0) {
+        throw std::runtime_error("--lsh-check demande --lsh=B,R");
+    }
+    return opt;
+}
+
+std::string usage() {
+    return "Usage : mpirun -np <p> ./build_dot fichier.fa [options]\n"
+           "  --distance=hamming|edit|weighted\n"
+           "                         distance de Hamming, d'edition (longueurs libres),\n"
+           "                         ou ponderee (defaut : hamming)\n"
+           "  --ts-tv=TS,TV          distance ponderee : cout d'une transition et d'une\n"
+           "                         transversion (defaut : 1,2)\n"
+           "  --position-weights=F   distance ponderee : un poids entier par position, lu dans F\n"
+           "  --kernel=packed|char|gemm\n"
+           "                         noyau de distance de Hamming (defaut : packed)\n"
+           "  --simd=auto|scalar|sse4.2|avx2|avx512\n"
+           "                         noyaux char et gemm : jeu d'instructions (defaut : auto)\n"
+           "  --bounded              arret du calcul des que la distance atteint epsilon\n"
+           "  --reader=parallel|rank0\n"
+           "                         lecture du FASTA par tous les rangs ou par le rang 0\n"
+           "                         (defaut : parallel)\n"
+           "  --writer=parallel|rank0\n"
+           "                         ecriture du .dot par tous les rangs (MPI-IO) ou par le rang 0\n"
+           "                         (defaut : parallel)\n"
+           "  --tile=T               cote des tuiles de paires (defaut : 0 = selon le cache L2)\n"
+           "  --threads=N            threads de calcul par processus (defaut : 1, 0 = tous les coeurs)\n"
+           "  --schedule=dynamic|static\n"
+           "                         tuiles prises au fur et a mesure dans un compteur partage,\n"
+           "                         ou meme nombre de paires par rang (defaut : dynamic)\n"
+           "  --ring                 chaque rang ne garde que ses sequences (n/p), les blocs\n"
+           "                         des autres rangs lui arrivent en anneau\n"
+           "  --lsh=B,R              ne verifier que les paires candidates du LSH :\n"
+           "                         B bandes de R positions tirees au hasard\n"
+           "  --lsh-check            refaire le calcul exact et afficher le rappel du LSH\n"
+           "  --save-edges=F         enregistrer les aretes dans F (pour un ajout plus tard)\n"
+           "  --append=F             reprendre les aretes de F et ne calculer que les paires\n"
+           "                         des sequences ajoutees a la fin du FASTA\n"
+           "  --dedup=F              un seul sommet par sequence distincte, copies ecrites dans F\n"
+           "  --epsilon=E1,E2,...    seuils des aretes (defaut : 70) : un seul calcul,\n"
+           "                         un graphe .dot par seuil\n"
+           "  --tagged-edges=F       ecrire dans F chaque arete avec le plus petit seuil\n"
+           "                         dont le graphe la contient\n"
+           "  --csr=F                ecrire aussi le graphe au format binaire CSR (lu par main_mpi)\n"
+           "  --no-dot               ne pas ecrire le .dot (avec --csr)\n";
+}
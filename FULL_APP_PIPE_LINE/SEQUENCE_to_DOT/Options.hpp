@@ -0,0 +1,121 @@
+#ifndef OPTIONS_HPP
+#define OPTIONS_HPP
+
+#include <string>
+#include <vector>
+#include "HammingKernels.hpp"
+
+/**
+ * @file Options.hpp
+ * @brief Lecture des options de la ligne de commande de build_dot.
+ *
+ * Usage :
+ * @code
+ *   mpirun -np <p> ./build_dot fichier.fa [--kernel=packed|char|gemm]
+ *                                         [--simd=auto|scalar|sse4.2|avx2|avx512]
+ *                                         [--bounded] [--reader=parallel|rank0]
+ *                                         [--writer=parallel|rank0]
+ *                                         [--tile=T] [--threads=N] [--schedule=dynamic|static]
+ *                                         [--ring]
+ *                                         [--distance=hamming|edit|weighted]
+ *                                         [--ts-tv=TS,TV] [--position-weights=poids.txt]
+ *                                         [--lsh=B,R] [--lsh-check]
+ *                                         [--epsilon=E1,E2,...] [--tagged-edges=aretes.txt]
+ *                                         [--append=old.edges] [--save-edges=new.edges]
+ *                                         [--dedup=groupes.txt] [--csr=graphe.csr] [--no-dot]
+ * @endcode
+ *
+ * Tous les rangs reçoivent les mêmes arguments, donc chaque rang lit
+ * les options lui-même (pas besoin de les diffuser).
+ */
+
+/**
+ * @brief Noyau utilisé pour calculer la distance de Hamming.
+ */
+enum class Kernel {
+    Char,    /**< Comparaison caractère par caractère sur le tableau brut. */
+    Packed,  /**< Séquences codées sur 2 bits, XOR + popcount (voir PackedSeqs.hpp). */
+    Gemm     /**< Produit de matrices sur le codage one-hot (voir GemmHamming.hpp). */
+};
+
+/**
+ * @brief Distance entre séquences utilisée pour le graphe.
+ */
+enum class Distance {
+    Hamming,   /**< Nombre de positions différentes (séquences de même longueur). */
+    Edit,      /**< Distance d'édition bornée par epsilon (voir EditDistance.hpp). */
+    Weighted   /**< Coûts transition / transversion et poids par position (voir WeightedDistance.hpp). */
+};
+
+/**
+ * @brief Façon de lire le fichier FASTA.
+ */
+enum class Reader {
+    Parallel,   /**< Chaque rang lit sa tranche du fichier (voir FastaReader.hpp). */
+    Rank0       /**< Le rang 0 lit tout et diffuse (fichier visible du rang 0 seulement). */
+};
+
+/**
+ * @brief Façon d'écrire le fichier DOT.
+ */
+enum class Writer {
+    Parallel,   /**< Chaque rang écrit sa tranche d'arêtes avec MPI-IO (voir DotWriter.hpp). */
+    Rank0       /**< Le rang 0 écrit tout le fichier. */
+};
+
+/**
+ * @brief Répartition des tuiles de paires entre les rangs.
+ */
+enum class Schedule {
+    Dynamic,   /**< Compteur partagé, les rangs prennent des paquets de tuiles (voir TileScheduler.hpp). */
+    Static     /**< Même nombre de paires par rang, fixé d'avance (voir tileRange). */
+};
+
+/**
+ * @struct BuildOptions
+ * @brief Paramètres d'exécution de build_dot.
+ */
+struct BuildOptions {
+    std::string fastaFile;            /**< Fichier FASTA d'entrée (argument obligatoire). */
+    Distance distance = Distance::Hamming; /**< Distance utilisée (--distance=). */
+    Kernel kernel = Kernel::Packed;   /**< Noyau de distance de Hamming (--kernel=). */
+    SimdLevel simd = SimdLevel::Auto; /**< Jeu d'instructions des noyaux char et gemm (--simd=). */
+    bool bounded = false;             /**< Distance bornée par epsilon, avec arrêt anticipé (--bounded). */
+    Reader reader = Reader::Parallel; /**< Lecture du FASTA (--reader=). */
+    Writer writer = Writer::Parallel; /**< Écriture du fichier DOT (--writer=). */
+    int tile = 0;                     /**< Côté des tuiles de paires, 0 = d'après le cache L2 (--tile=). */
+    int threads = 1;                  /**< Threads de calcul par rang, 0 = tous les cœurs (--threads=). */
+    Schedule schedule = Schedule::Dynamic; /**< Répartition des tuiles entre les rangs (--schedule=). */
+    bool ring = false;                /**< Séquences réparties, blocs qui tournent entre les rangs (--ring). */
+    int lshBands = 0;                 /**< Bandes du filtre LSH, 0 = toutes les paires (--lsh=B,R). */
+    int lshRows = 0;                  /**< Positions tirées par bande du filtre LSH. */
+    bool lshCheck = false;            /**< Refaire le calcul exact pour mesurer le rappel (--lsh-check). */
+    std::string appendFile;           /**< Arêtes d'un calcul précédent à compléter (--append=). */
+    std::string saveEdgesFile;        /**< Fichier où enregistrer les arêtes (--save-edges=). */
+    std::string dedupFile;            /**< Regrouper les doublons, groupes écrits ici (--dedup=). */
+    std::string csrFile;              /**< Graphe binaire CSR pour Floyd (--csr=), vide = pas de CSR. */
+    bool writeDot = true;             /**< Écrire aussi le graphe .dot (désactivé par --no-dot). */
+    std::vector<int> epsilons;        /**< Seuils des graphes, croissants, vide = 70 (--epsilon=). */
+    std::string taggedEdgesFile;      /**< Arêtes avec leur plus petit seuil (--tagged-edges=). */
+    int transitionCost = 1;           /**< Distance pondérée : coût d'une transition (--ts-tv=TS,TV). */
+    int transversionCost = 2;         /**< Distance pondérée : coût d'une transversion. */
+    std::string positionWeightsFile;  /**< Distance pondérée : poids par position (--position-weights=). */
+};
+
+/**
+ * @brief Analyse les arguments de la ligne de commande.
+ *
+ * @param argc Nombre d'arguments.
+ * @param argv Tableau d'arguments.
+ * @return Les options lues.
+ *
+ * @throw std::runtime_error si un argument est manquant ou invalide.
+ */
+BuildOptions parseOptions(int argc, char** argv);
+
+/**
+ * @brief Texte d'aide affiché quand les arguments sont invalides.
+ */
+std::string usage();
+
+#endif // OPTIONS_HPP
@@ -0,0 +1,247 @@
+#define OMPI_SKIP_MPICXX 1
+#include "PackedSeqs.hpp"
+#include <algorithm>
+
+// Code 2 bits d'une base, ou -1 si la base n'est pas dans l'alphabet
+// (dans ce cas c'est une exception).
+static int encodeBase(char c) {
+    switch (c) {
+        case 'A': return 0;
+        case 'C': return 1;
+        case 'G': return 2;
+        case 'T':
+        case 'U': return 3;
+        default:  return -1;
+    }
+}
+
+PackedSeqs packSequences(const char* allSeqs, int n, int L) {
+    PackedSeqs ps;
+    ps.n = n;
+    ps.L = L;
+    ps.words = (L + 31) / 32;
+    ps.codes.assign((size_t)n * ps.words, 0);
+    ps.excOffset.resize(n + 1);
+
+    for (int i = 0; i < n; ++i) {
+        ps.excOffset[i] = (int)ps.excPos.size();
+        const char* seq = &allSeqs[(size_t)i * L];
+        uint64_t* out = &ps.codes[(size_t)i * ps.words];
+
+        for (int p = 0; p < L; ++p) {
+            int code = encodeBase(seq[p]);
+            if (code < 0) {
+                // Base hors alphabet : je la code 0 et je la garde de côté
+                ps.excPos.push_back(p);
+                ps.excChar.push_back(seq[p]);
+                code = 0;
+            }
+            out[p >> 5] |= (uint64_t)code << (2 * (p & 31));
+        }
+    }
+    ps.excOffset[n] = (int)ps.excPos.size();
+
+    return ps;
+}
+
+void bcastPackedSeqs(PackedSeqs& ps, int root, MPI_Comm comm) {
+    int rank;
+    MPI_Comm_rank(comm, &rank);
+
+    int header[3] = {ps.n, ps.L, (int)ps.excPos.size()};
+    MPI_Bcast(header, 3, MPI_INT, root, comm);
+
+    if (rank != root) {
+        ps.n = header[0];
+        ps.L = header[1];
+        ps.words = (ps.L + 31) / 32;
+        ps.codes.resize((size_t)ps.n * ps.words);
+        ps.excOffset.resize(ps.n + 1);
+        ps.excPos.resize(header[2]);
+        ps.excChar.resize(header[2]);
+    }
+
+    MPI_Bcast(ps.codes.data(), (int)ps.codes.size(), MPI_UINT64_T, root, comm);
+    MPI_Bcast(ps.excOffset.data(), ps.n + 1, MPI_INT, root, comm);
+    if (header[2] > 0) {
+        MPI_Bcast(ps.excPos.data(), header[2], MPI_INT, root, comm);
+        MPI_Bcast(ps.excChar.data(), header[2], MPI_CHAR, root, comm);
+    }
+}
+
+PackedSeqs allgatherPackedSeqs(const PackedSeqs& local, MPI_Comm comm) {
+    int size;
+    MPI_Comm_size(comm, &size);
+
+    // Combien de séquences et d'exceptions chaque rang apporte
+    int mine[2] = {local.n, (int)local.excPos.size()};
+    std::vector<int> all(2 * size);
+    MPI_Allgather(mine, 2, MPI_INT, all.data(), 2, MPI_INT, comm);
+
+    std::vector<int> seqCounts(size), seqDispls(size), excCounts(size), excDispls(size);
+    int nTotal = 0, excTotal = 0;
+    for (int r = 0; r < size; ++r) {
+        seqCounts[r] = all[2 * r];
+        excCounts[r] = all[2 * r + 1];
+        seqDispls[r] = nTotal;
+        excDispls[r] = excTotal;
+        nTotal   += seqCounts[r];
+        excTotal += excCounts[r];
+    }
+
+    PackedSeqs ps;
+    ps.n = nTotal;
+    ps.L = local.L;
+    ps.words = local.words;
+    ps.codes.resize((size_t)ps.n * ps.words);
+    ps.excOffset.resize(ps.n + 1);
+    ps.excPos.resize(excTotal);
+    ps.excChar.resize(excTotal);
+
+    // Les codes : un élément = une séquence (words mots de 64 bits)
+    MPI_Datatype seqType;
+    MPI_Type_contiguous(ps.words, MPI_UINT64_T, &seqType);
+    MPI_Type_commit(&seqType);
+    MPI_Allgatherv(local.codes.data(), local.n, seqType,
+                   ps.codes.data(), seqCounts.data(), seqDispls.data(), seqType, comm);
+    MPI_Type_free(&seqType);
+
+    // Les exceptions : nombre par séquence, puis positions et caractères
+    std::vector<int> localExcCount(local.n);
+    for (int i = 0; i < local.n; ++i) {
+        localExcCount[i] = local.excOffset[i + 1] - local.excOffset[i];
+    }
+    MPI_Allgatherv(localExcCount.data(), local.n, MPI_INT,
+                   ps.excOffset.data() + 1, seqCounts.data(), seqDispls.data(), MPI_INT, comm);
+    ps.excOffset[0] = 0;
+    for (int i = 0; i < ps.n; ++i) {
+        ps.excOffset[i + 1] += ps.excOffset[i];
+    }
+
+    MPI_Allgatherv(local.excPos.data(), mine[1], MPI_INT,
+                   ps.excPos.data(), excCounts.data(), excDispls.data(), MPI_INT, comm);
+    MPI_Allgatherv(local.excChar.data(), mine[1], MPI_CHAR,
+                   ps.excChar.data(), excCounts.data(), excDispls.data(), MPI_CHAR, comm);
+
+    return ps;
+}
+
+// Corrige la distance calculée sur les codes aux positions des exceptions :
+// on parcourt l'union triée des positions, on retire ce que le code compact
+// a compté et on met la vraie comparaison des caractères.
+// La correction est toujours >= 0 : une exception est codée 0 (comme A) et
+// n'est égale à aucune base de l'alphabet, donc une paire comptée différente
+// par les codes l'est aussi en vrai.
+static int exceptionCorrection(const PackedSeqs& ps, const uint64_t* a, const uint64_t* b,
+                               int i, int j)
+{
+    int pa = ps.excOffset[i], ea = ps.excOffset[i + 1];
+    int pb = ps.excOffset[j], eb = ps.excOffset[j + 1];
+
+    int corr = 0;
+    while (pa < ea || pb < eb) {
+        int p;
+        if (pb == eb || (pa < ea && ps.excPos[pa] < ps.excPos[pb])) {
+            p = ps.excPos[pa];
+        } else {
+            p = ps.excPos[pb];
+        }
+
+        int codeA = codeAt(a, p);
+        int codeB = codeAt(b, p);
+        // Le caractère exact n'a pas d'importance quand il n'y a pas d'exception :
+        // une exception n'est jamais égale à une base de l'alphabet.
+        char ca = (pa < ea && ps.excPos[pa] == p) ? ps.excChar[pa++] : (char)codeA;
+        char cb = (pb < eb && ps.excPos[pb] == p) ? ps.excChar[pb++] : (char)codeB;
+
+        corr += (ca != cb ? 1 : 0) - (codeA != codeB ? 1 : 0);
+    }
+    return corr;
+}
+
+PackedSeqs selectPacked(const PackedSeqs& ps, const std::vector<int>& keep) {
+    PackedSeqs out;
+    out.n = (int)keep.size();
+    out.L = ps.L;
+    out.words = ps.words;
+    out.codes.resize((size_t)out.n * out.words);
+    out.excOffset.resize(out.n + 1);
+
+    for (int u = 0; u < out.n; ++u) {
+        const int i = keep[u];
+        std::copy(&ps.codes[(size_t)i * ps.words], &ps.codes[(size_t)(i + 1) * ps.words],
+                  &out.codes[(size_t)u * out.words]);
+        out.excOffset[u] = (int)out.excPos.size();
+        for (int e = ps.excOffset[i]; e < ps.excOffset[i + 1]; ++e) {
+            out.excPos.push_back(ps.excPos[e]);
+            out.excChar.push_back(ps.excChar[e]);
+        }
+    }
+    out.excOffset[out.n] = (int)out.excPos.size();
+    return out;
+}
+
+PackedSeqs concatPacked(const PackedSeqs& a, const PackedSeqs& b) {
+    PackedSeqs out;
+    out.n = a.n + b.n;
+    out.L = a.L;
+    out.words = a.words;
+    out.codes.reserve(a.codes.size() + b.codes.size());
+    out.codes.insert(out.codes.end(), a.codes.begin(), a.codes.end());
+    out.codes.insert(out.codes.end(), b.codes.begin(), b.codes.end());
+
+    // Les exceptions de b sont décalées de celles de a
+    out.excOffset.assign(a.excOffset.begin(), a.excOffset.end());
+    if (out.excOffset.empty()) out.excOffset.push_back(0);
+    const int shift = (int)a.excPos.size();
+    for (int j = 1; j <= b.n; ++j) out.excOffset.push_back(b.excOffset[j] + shift);
+    out.excPos = a.excPos;
+    out.excPos.insert(out.excPos.end(), b.excPos.begin(), b.excPos.end());
+    out.excChar = a.excChar;
+    out.excChar.insert(out.excChar.end(), b.excChar.begin(), b.excChar.end());
+    return out;
+}
+
+char baseAt(const PackedSeqs& ps, int i, int p) {
+    // Les exceptions de la séquence sont triées par position
+    const int* b = ps.excPos.data() + ps.excOffset[i];
+    const int* e = ps.excPos.data() + ps.excOffset[i + 1];
+    const int* it = std::lower_bound(b, e, p);
+    if (it != e && *it == p) return ps.excChar[it - ps.excPos.data()];
+    return "ACGT"[codeAt(&ps.codes[(size_t)i * ps.words], p)];
+}
+
+int hammingPacked(const PackedSeqs& ps, int i, int j) {
+    const uint64_t* a = &ps.codes[(size_t)i * ps.words];
+    const uint64_t* b = &ps.codes[(size_t)j * ps.words];
+
+    int d = 0;
+    for (int w = 0; w < ps.words; ++w) {
+        // Une base différente donne au moins un bit à 1 dans sa paire :
+        // je replie la paire sur son bit de poids faible avant de compter.
+        uint64_t x = a[w] ^ b[w];
+        x = (x | (x >> 1)) & LOW_BITS;
+        d += __builtin_popcountll(x);
+    }
+
+    return d + exceptionCorrection(ps, a, b, i, j);
+}
+
+int hammingPackedBounded(const PackedSeqs& ps, int i, int j, int bound) {
+    const uint64_t* a = &ps.codes[(size_t)i * ps.words];
+    const uint64_t* b = &ps.codes[(size_t)j * ps.words];
+
+    // Comme la correction des exceptions ne fait qu'augmenter la distance,
+    // le compte sur les codes est un minorant : je peux m'arrêter dès qu'il
+    // atteint la borne, sans regarder les exceptions.
+    int d = 0;
+    for (int w = 0; w < ps.words; ++w) {
+        uint64_t x = a[w] ^ b[w];
+        x = (x | (x >> 1)) & LOW_BITS;
+        d += __builtin_popcountll(x);
+        if (d >= bound) return bound;
+    }
+
+    d += exceptionCorrection(ps, a, b, i, j);
+    return d < bound ? d : bound;
+}
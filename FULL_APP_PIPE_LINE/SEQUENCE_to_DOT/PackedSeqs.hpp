@@ -0,0 +1,129 @@
+#ifndef PACKED_SEQS_HPP
+#define PACKED_SEQS_HPP
+
+#include <mpi.h>
+#include <cstdint>
+#include <vector>
+
+/**
+ * @file PackedSeqs.hpp
+ * @brief Représentation compacte (2 bits par base) des séquences d'ARN / ADN
+ *        et distance de Hamming calculée mot par mot (XOR + popcount).
+ *
+ * Chaque base A, C, G, T (ou U) est codée sur 2 bits :
+ *   A = 0, C = 1, G = 2, T/U = 3.
+ * Un mot de 64 bits contient donc 32 bases, et une séquence de longueur L
+ * occupe ceil(L / 32) mots.
+ *
+ * Les bases qui ne sont pas dans l'alphabet (N, bases ambiguës, minuscules, ...)
+ * sont des "exceptions" : elles sont codées 0 dans le tableau compact et leur
+ * position + caractère d'origine sont gardés à part. La distance les corrige
+ * ensuite une par une, ce qui reste négligeable tant qu'elles sont rares.
+ *
+ * Remarque : T et U ont le même code, ils sont donc considérés comme égaux.
+ */
+
+/**
+ * @struct PackedSeqs
+ * @brief Ensemble de n séquences de longueur L codées sur 2 bits par base.
+ *
+ * La séquence i occupe les mots codes[i * words .. (i + 1) * words - 1].
+ * Ses exceptions sont aux indices [excOffset[i], excOffset[i + 1]) de
+ * excPos / excChar, triées par position croissante.
+ */
+struct PackedSeqs {
+    int n = 0;                     /**< Nombre de séquences. */
+    int L = 0;                     /**< Longueur (commune) des séquences. */
+    int words = 0;                 /**< Nombre de mots de 64 bits par séquence = ceil(L / 32). */
+    std::vector<uint64_t> codes;   /**< Bases codées, n * words mots. */
+    std::vector<int> excOffset;    /**< Début des exceptions de chaque séquence (taille n + 1). */
+    std::vector<int> excPos;       /**< Position de chaque exception dans sa séquence. */
+    std::vector<char> excChar;     /**< Caractère d'origine de chaque exception. */
+};
+
+/**
+ * @brief Code un tableau contigu de n séquences de longueur L sur 2 bits par base.
+ *
+ * @param allSeqs Tableau de taille n * L, la séquence i commence à l'offset i * L.
+ * @param n       Nombre de séquences.
+ * @param L       Longueur de chaque séquence.
+ * @return Les séquences codées, avec leurs exceptions.
+ */
+PackedSeqs packSequences(const char* allSeqs, int n, int L);
+
+/**
+ * @brief Diffuse un PackedSeqs depuis le rang root vers tous les processus de comm.
+ *
+ * Sur les rangs différents de root, la structure est redimensionnée puis remplie.
+ * Le volume envoyé est d'environ L / 4 octets par séquence (au lieu de L).
+ *
+ * @param ps   Séquences codées (remplies sur root, écrasées ailleurs).
+ * @param root Rang qui possède les données.
+ * @param comm Communicateur MPI.
+ */
+void bcastPackedSeqs(PackedSeqs& ps, int root, MPI_Comm comm);
+
+/**
+ * @brief Concatène sur tous les rangs les séquences codées par chacun.
+ *
+ * Utilisé avec la lecture parallèle : chaque rang code les séquences qu'il
+ * a lues, puis on met tout en commun (dans l'ordre des rangs).
+ *
+ * @param local Séquences codées par ce rang (même L partout).
+ * @param comm  Communicateur MPI.
+ * @return L'ensemble complet des séquences codées.
+ */
+PackedSeqs allgatherPackedSeqs(const PackedSeqs& local, MPI_Comm comm);
+
+/**
+ * @brief Garde seulement les séquences keep[0], keep[1], ... (dans cet ordre).
+ */
+PackedSeqs selectPacked(const PackedSeqs& ps, const std::vector<int>& keep);
+
+/**
+ * @brief Met les séquences de b à la suite de celles de a (même L).
+ *
+ * La séquence j de b devient la séquence a.n + j du résultat.
+ */
+PackedSeqs concatPacked(const PackedSeqs& a, const PackedSeqs& b);
+
+/** @brief Masque qui garde le bit de poids faible de chaque paire de bits : 0101...01 */
+const uint64_t LOW_BITS = 0x5555555555555555ULL;
+
+/**
+ * @brief Code 2 bits de la base en position p d'une séquence codée
+ *        (la base p est dans le mot p / 32, aux bits 2 * (p % 32) et suivant).
+ */
+inline int codeAt(const uint64_t* seq, int p) {
+    return (int)((seq[p >> 5] >> (2 * (p & 31))) & 3ULL);
+}
+
+/**
+ * @brief Base en position p de la séquence i, telle qu'elle était avant codage
+ *        (sauf U, rendu comme T puisqu'ils ont le même code).
+ */
+char baseAt(const PackedSeqs& ps, int i, int p);
+
+/**
+ * @brief Distance de Hamming entre les séquences i et j de ps.
+ *
+ * Le calcul se fait 32 bases à la fois : XOR des deux mots, puis on replie
+ * chaque paire de bits sur un seul bit et on compte avec popcount.
+ * Si l'une des deux séquences a des exceptions, les positions concernées sont
+ * recomparées avec leurs caractères d'origine.
+ *
+ * @return Le nombre de positions p telles que seq_i[p] != seq_j[p].
+ */
+int hammingPacked(const PackedSeqs& ps, int i, int j);
+
+/**
+ * @brief Distance de Hamming bornée entre les séquences i et j de ps.
+ *
+ * Même calcul que hammingPacked, mais on s'arrête dès que le compte atteint
+ * bound (ce compte ne peut ensuite qu'augmenter) et on renvoie bound.
+ *
+ * @return min(distance(i, j), bound).
+ */
+int hammingPackedBounded(const PackedSeqs& ps, int i, int j, int bound);
+
+#endif // PACKED_SEQS_HPP
@@ -0,0 +1,67 @@
+#define OMPI_SKIP_MPICXX 1
+#include "RingExchange.hpp"
+
+RingLayout ringLayout(const PackedSeqs& local, int first, MPI_Comm comm) {
+    int size;
+    MPI_Comm_size(comm, &size);
+
+    int mine[3] = {first, local.n, (int)local.excPos.size()};
+    std::vector<int> all(3 * size);
+    MPI_Allgather(mine, 3, MPI_INT, all.data(), 3, MPI_INT, comm);
+
+    RingLayout layout;
+    for (int r = 0; r < size; ++r) {
+        layout.first.push_back(all[3 * r]);
+        layout.count.push_back(all[3 * r + 1]);
+        layout.nExc.push_back(all[3 * r + 2]);
+    }
+    return layout;
+}
+
+RingShift::RingShift(int words, MPI_Comm comm) : comm_(comm) {
+    int rank, size;
+    MPI_Comm_rank(comm, &rank);
+    MPI_Comm_size(comm, &size);
+    next_ = (rank + 1) % size;
+    prev_ = (rank + size - 1) % size;
+
+    MPI_Type_contiguous(words, MPI_UINT64_T, &seqType_);
+    MPI_Type_commit(&seqType_);
+}
+
+RingShift::~RingShift() {
+    MPI_Type_free(&seqType_);
+}
+
+void RingShift::start(const PackedSeqs& send, PackedSeqs& recv, int block, const RingLayout& layout) {
+    // Tout est dimensionné d'avance : les tailles de chaque bloc sont connues
+    recv.n = layout.count[block];
+    recv.L = send.L;
+    recv.words = send.words;
+    recv.codes.resize((size_t)recv.n * recv.words);
+    recv.excOffset.resize(recv.n + 1);
+    recv.excPos.resize(layout.nExc[block]);
+    recv.excChar.resize(layout.nExc[block]);
+
+    // Un message par tableau (étiquettes 0 à 3), dans le même ordre des deux côtés
+    requests_.assign(8, MPI_REQUEST_NULL);
+    MPI_Irecv(recv.codes.data(), recv.n, seqType_, prev_, 0, comm_, &requests_[0]);
+    MPI_Irecv(recv.excOffset.data(), recv.n + 1, MPI_INT, prev_, 1, comm_, &requests_[1]);
+    MPI_Irecv(recv.excPos.data(), (int)recv.excPos.size(), MPI_INT, prev_, 2, comm_, &requests_[2]);
+    MPI_Irecv(recv.excChar.data(), (int)recv.excChar.size(), MPI_CHAR, prev_, 3, comm_, &requests_[3]);
+
+    MPI_Isend(send.codes.data(), send.n, seqType_, next_, 0, comm_, &requests_[4]);
+    MPI_Isend(send.excOffset.data(), send.n + 1, MPI_INT, next_, 1, comm_, &requests_[5]);
+    MPI_Isend(send.excPos.data(), (int)send.excPos.size(), MPI_INT, next_, 2, comm_, &requests_[6]);
+    MPI_Isend(send.excChar.data(), (int)send.excChar.size(), MPI_CHAR, next_, 3, comm_, &requests_[7]);
+}
+
+void RingShift::test() {
+    int fini;
+    MPI_Testall((int)requests_.size(), requests_.data(), &fini, MPI_STATUSES_IGNORE);
+}
+
+void RingShift::wait() {
+    MPI_Waitall((int)requests_.size(), requests_.data(), MPI_STATUSES_IGNORE);
+    requests_.clear();
+}
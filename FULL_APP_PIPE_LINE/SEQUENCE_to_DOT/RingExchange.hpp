@@ -0,0 +1,85 @@
+#ifndef RING_EXCHANGE_HPP
+#define RING_EXCHANGE_HPP
+
+#include <mpi.h>
+#include <vector>
+#include "PackedSeqs.hpp"
+
+/**
+ * @file RingExchange.hpp
+ * @brief Circulation des blocs de séquences codées autour d'un anneau de rangs (--ring).
+ *
+ * Sans anneau, chaque rang reçoit toutes les séquences (MPI_Allgatherv ou
+ * MPI_Bcast) : la mémoire par rang est en O(nL). En mode anneau, chaque rang
+ * ne garde que le bloc qu'il a lu (environ n/p séquences) et voit passer les
+ * blocs des autres rangs un par un : à l'étape s, le rang r compare ses
+ * séquences au bloc du rang (r - s) mod p, et il le transmet au rang r + 1
+ * pendant qu'il reçoit le suivant du rang r - 1. Les envois et réceptions
+ * sont non bloquants et se font pendant le calcul de l'étape : le thread
+ * principal appelle test() entre deux tuiles, car beaucoup d'implémentations
+ * MPI ne font avancer les messages que pendant un appel MPI.
+ *
+ * Une paire de blocs {r, q} est vue par r à l'étape (r - q) mod p et par q à
+ * l'étape (q - r) mod p : il suffit donc de faire tourner les blocs sur
+ * floor(p / 2) étapes. Avec p pair, à l'étape p / 2 les deux rangs voient la
+ * même paire de blocs et s'en partagent les lignes.
+ */
+
+/**
+ * @struct RingLayout
+ * @brief Taille et place des blocs de tous les rangs.
+ */
+struct RingLayout {
+    std::vector<int> first;   /**< Indice global de la première séquence du bloc de chaque rang. */
+    std::vector<int> count;   /**< Nombre de séquences du bloc de chaque rang. */
+    std::vector<int> nExc;    /**< Nombre d'exceptions du bloc de chaque rang. */
+};
+
+/**
+ * @brief Échange la description des blocs (collectif).
+ *
+ * @param local Bloc de ce rang.
+ * @param first Indice global de sa première séquence.
+ */
+RingLayout ringLayout(const PackedSeqs& local, int first, MPI_Comm comm);
+
+/**
+ * @class RingShift
+ * @brief Un décalage de l'anneau : envoi d'un bloc au rang suivant et
+ *        réception d'un bloc du rang précédent, en non bloquant.
+ */
+class RingShift {
+public:
+    /** @param words Mots de 64 bits par séquence (les mêmes pour tous les blocs). */
+    RingShift(int words, MPI_Comm comm);
+    ~RingShift();
+
+    RingShift(const RingShift&) = delete;
+    RingShift& operator=(const RingShift&) = delete;
+
+    /**
+     * @brief Lance l'envoi de send au rang suivant et la réception, dans recv,
+     *        du bloc du rang block (qui arrive par le rang précédent).
+     *
+     * send et recv ne doivent pas être modifiés (ni lus pour recv) avant wait().
+     */
+    void start(const PackedSeqs& send, PackedSeqs& recv, int block, const RingLayout& layout);
+
+    /**
+     * @brief Fait avancer l'envoi et la réception en cours, sans attendre
+     *        (MPI_Testall). À appeler régulièrement pendant le calcul.
+     */
+    void test();
+
+    /** @brief Attend la fin de l'envoi et de la réception lancés par start(). */
+    void wait();
+
+private:
+    MPI_Comm comm_;
+    MPI_Datatype seqType_;    // une séquence = words mots
+    int next_;
+    int prev_;
+    std::vector<MPI_Request> requests_;
+};
+
+#endif // RING_EXCHANGE_HPP
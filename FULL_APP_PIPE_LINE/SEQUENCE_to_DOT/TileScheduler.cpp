@@ -0,0 +1,56 @@
+#define OMPI_SKIP_MPICXX 1
+#include "TileScheduler.hpp"
+#include <algorithm>
+
+TileScheduler::TileScheduler(std::size_t nTasks, int minChunk, MPI_Comm comm)
+    : nTasks_(nTasks), minChunk_(std::max(1, minChunk))
+{
+    MPI_Comm_rank(comm, &rank_);
+    MPI_Comm_size(comm, &size_);
+
+    // Le compteur n'existe que sur le rang 0 ; les autres exposent une fenêtre vide
+    MPI_Aint bytes = (rank_ == 0) ? (MPI_Aint)sizeof(long long) : 0;
+    MPI_Win_allocate(bytes, sizeof(long long), MPI_INFO_NULL, comm, &counter_, &win_);
+
+    // Une seule époque d'accès pour tout le calcul : chaque tirage n'a plus
+    // besoin que d'un flush, sans verrou ni synchronisation avec le rang 0.
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, win_);
+
+    // Écriture locale du compteur : avec le modèle mémoire "séparé", il faut
+    // MPI_Win_sync pour qu'elle soit visible des accès distants. Le compteur
+    // doit être à 0 avant le premier tirage d'un autre rang (barrière).
+    if (rank_ == 0) {
+        *counter_ = 0;
+        MPI_Win_sync(win_);
+    }
+    MPI_Barrier(comm);
+}
+
+TileScheduler::~TileScheduler() {
+    MPI_Win_unlock_all(win_);
+    MPI_Win_free(&win_);
+}
+
+void TileScheduler::progress() {
+    // Un flush sur le rang 0 lui-même ne transfère rien, mais fait tourner le
+    // moteur de progression, qui traite les Fetch_and_op arrivés entre-temps.
+    if (rank_ == 0) MPI_Win_flush(0, win_);
+}
+
+bool TileScheduler::next(std::size_t& begin, std::size_t& end) {
+    if (seen_ >= nTasks_) return false;
+
+    const std::size_t remaining = nTasks_ - seen_;
+    const long long chunk = (long long)std::max<std::size_t>((std::size_t)minChunk_,
+                                                             remaining / (2 * (std::size_t)size_));
+    long long first = 0;
+    MPI_Fetch_and_op(&chunk, &first, MPI_LONG_LONG, 0, 0, MPI_SUM, win_);
+    MPI_Win_flush(0, win_);
+
+    // Le compteur dépasse nTasks à la fin : les valeurs au-delà ne servent pas
+    begin = std::min((std::size_t)first, nTasks_);
+    end = std::min((std::size_t)(first + chunk), nTasks_);
+    seen_ = end;
+    taken_ += end - begin;
+    return begin < end;
+}
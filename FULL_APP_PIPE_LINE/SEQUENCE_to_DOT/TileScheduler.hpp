@@ -0,0 +1,85 @@
+#ifndef TILE_SCHEDULER_HPP
+#define TILE_SCHEDULER_HPP
+
+#include <mpi.h>
+#include <cstddef>
+
+/**
+ * @file TileScheduler.hpp
+ * @brief Répartition dynamique des tuiles entre les rangs MPI (--schedule=dynamic).
+ *
+ * Avec la répartition statique (tileRange), chaque rang reçoit d'avance le même
+ * nombre de paires : le plus lent (distance bornée qui s'arrête moins souvent,
+ * nœud partagé, processeur plus ancien) fixe la durée totale, et les autres
+ * l'attendent à la barrière. Ici, les rangs prennent leurs tuiles au fur et à
+ * mesure dans un compteur partagé, hébergé par le rang 0 dans une fenêtre MPI
+ * et incrémenté avec MPI_Fetch_and_op, et le rang 0 calcule comme tout le monde.
+ *
+ * Le rang 0 n'a rien à répondre lui-même, mais selon le réseau il doit quand
+ * même être dans MPI pour que les opérations des autres aboutissent : en
+ * mémoire partagée ou avec du RDMA matériel, la carte ou la bibliothèque font
+ * l'opération seules ; sur TCP (osc/pt2pt, ou rdma sur btl/tcp d'Open MPI),
+ * c'est le moteur de progression du rang 0 qui la traite. Son thread principal
+ * appelle donc progress() entre deux tuiles, sinon les autres rangs
+ * attendraient jusqu'à la fin de son paquet (le premier vaut nTasks / 2p tuiles).
+ *
+ * Les tuiles sont prises par paquets décroissants (comme le "guided" d'OpenMP) :
+ * un paquet vaut une part du reste vu au dernier tirage, divisée par 2 × le
+ * nombre de rangs, mais au moins une tuile par thread. Les premiers paquets
+ * sont gros (peu d'accès au compteur), les derniers petits (fin équilibrée).
+ */
+
+/**
+ * @class TileScheduler
+ * @brief Compteur de tuiles partagé par tous les rangs d'un communicateur.
+ *
+ * Le constructeur et le destructeur sont collectifs (création et libération
+ * de la fenêtre) : tous les rangs doivent créer l'objet ensemble. Seul le
+ * thread principal appelle next() et progress() (MPI_THREAD_FUNNELED).
+ */
+class TileScheduler {
+public:
+    /**
+     * @brief Crée le compteur, à 0, pour les tâches [0, nTasks).
+     *
+     * @param nTasks   Nombre de tuiles à répartir.
+     * @param minChunk Plus petit paquet (en pratique le nombre de threads du rang).
+     * @param comm     Communicateur des rangs qui se partagent les tuiles.
+     */
+    TileScheduler(std::size_t nTasks, int minChunk, MPI_Comm comm);
+
+    /** @brief Libère la fenêtre (collectif). */
+    ~TileScheduler();
+
+    TileScheduler(const TileScheduler&) = delete;
+    TileScheduler& operator=(const TileScheduler&) = delete;
+
+    /**
+     * @brief Prend le prochain paquet de tuiles [begin, end).
+     *
+     * @return false quand toutes les tuiles ont été prises.
+     */
+    bool next(std::size_t& begin, std::size_t& end);
+
+    /**
+     * @brief Fait avancer les tirages des autres rangs (rang 0), sans attendre.
+     *        À appeler régulièrement pendant le calcul d'un paquet ; ne fait
+     *        rien sur les autres rangs.
+     */
+    void progress();
+
+    /** @brief Nombre de tuiles prises par ce rang jusqu'ici. */
+    std::size_t taken() const { return taken_; }
+
+private:
+    MPI_Win win_;
+    long long* counter_ = nullptr;   // compteur (rang 0 seulement)
+    std::size_t nTasks_;
+    int minChunk_;
+    int size_;
+    int rank_;
+    std::size_t seen_ = 0;           // valeur du compteur au dernier tirage
+    std::size_t taken_ = 0;
+};
+
+#endif // TILE_SCHEDULER_HPP
@@ -0,0 +1,87 @@
+#include "Tiles.hpp"
+#include <algorithm>
+#include <cmath>
+#include <unistd.h>
+
+long long tilePairs(const Tile& t) {
+    long long h = t.i1 - t.i0;
+    long long w = t.j1 - t.j0;
+    if (t.i0 != t.j0) return h * w;
+    // Tuile diagonale (carrée) : seulement le triangle strictement supérieur
+    return h * (h - 1) / 2;
+}
+
+std::vector<Tile> upperTriangleTiles(int n, int T, int firstCol) {
+    // Bornes des groupes de séquences : tous les T jusqu'à firstCol,
+    // puis de nouveau tous les T à partir de firstCol.
+    std::vector<int> cuts;
+    for (int c = 0; c < firstCol; c += T) cuts.push_back(c);
+    for (int c = firstCol; c < n; c += T) cuts.push_back(c);
+    cuts.push_back(n);
+
+    const int groups = (int)cuts.size() - 1;
+    int firstGroup = 0;   // premier groupe de colonnes à calculer
+    while (firstGroup < groups && cuts[firstGroup] < firstCol) ++firstGroup;
+
+    std::vector<Tile> tiles;
+    for (int I = 0; I < groups; ++I) {
+        for (int J = std::max(I, firstGroup); J < groups; ++J) {
+            Tile t = {cuts[I], cuts[I + 1], cuts[J], cuts[J + 1]};
+            if (tilePairs(t) > 0) tiles.push_back(t);
+        }
+    }
+    return tiles;
+}
+
+std::vector<Tile> rectangleTiles(int i0, int i1, int j0, int j1, int T) {
+    std::vector<Tile> tiles;
+    for (int i = i0; i < i1; i += T) {
+        for (int j = j0; j < j1; j += T) {
+            tiles.push_back({i, std::min(i + T, i1), j, std::min(j + T, j1)});
+        }
+    }
+    return tiles;
+}
+
+void tileRange(const std::vector<Tile>& tiles, int rank, int size,
+               std::size_t& tBegin, std::size_t& tEnd)
+{
+    long long total = 0;
+    for (const Tile& t : tiles) total += tilePairs(t);
+
+    // Ma part de paires est [lo, hi) ; je prends les tuiles qui y commencent.
+    const long long lo = total * rank / size;
+    const long long hi = total * (rank + 1) / size;
+
+    tBegin = tEnd = tiles.size();
+    long long before = 0;   // nombre de paires avant la tuile k
+    bool started = false;
+    for (std::size_t k = 0; k < tiles.size(); ++k) {
+        if (!started && before >= lo) {
+            tBegin = k;
+            started = true;
+        }
+        if (before >= hi) {
+            tEnd = k;
+            break;
+        }
+        before += tilePairs(tiles[k]);
+    }
+}
+
+int autoTileSize(std::size_t bytesPerSeq, int n, int size) {
+    long l2 = -1;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+    l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+#endif
+    if (l2 <= 0) l2 = 256 * 1024;   // valeur prudente si le système ne sait pas
+
+    std::size_t T = (std::size_t)l2 / 2 / (2 * std::max<std::size_t>(1, bytesPerSeq));
+
+    // Il faut aussi assez de tuiles pour équilibrer les rangs : avec (n/T)²/2
+    // tuiles, en viser au moins 8 par rang donne T <= n / sqrt(16 p).
+    std::size_t maxT = (std::size_t)(n / std::sqrt(16.0 * size));
+    T = std::min(T, maxT);
+    T = std::max<std::size_t>(16, T);
+    return (int)std::min<std::size_t>(T, (std::size_t)std::max(1, n));
+}
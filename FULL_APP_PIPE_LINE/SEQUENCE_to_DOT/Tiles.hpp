@@ -0,0 +1,99 @@
+#ifndef TILES_HPP
+#define TILES_HPP
+
+#include <cstddef>
+#include <vector>
+
+/**
+ * @file Tiles.hpp
+ * @brief Découpage du triangle supérieur des paires (i < j) en tuiles.
+ *
+ * Une tuile compare un groupe de T lignes [i0, i1) à un groupe de T colonnes
+ * [j0, j1). Pendant qu'on parcourt la tuile, les T séquences colonnes sont
+ * relues pour chaque ligne : si 2T séquences tiennent dans le cache, elles
+ * restent en cache au lieu d'être relues depuis la mémoire à chaque ligne
+ * (ce qui arrive quand une ligne compare i à toutes les autres séquences).
+ *
+ * Les tuiles sont numérotées ligne de tuiles par ligne de tuiles, et seules les
+ * tuiles J >= I sont gardées ; dans une tuile diagonale (I == J) on ne calcule
+ * que les paires i < j.
+ */
+
+/**
+ * @struct Tile
+ * @brief Tuile de paires : lignes [i0, i1) × colonnes [j0, j1), avec i < j.
+ */
+struct Tile {
+    int i0;   /**< Première ligne (incluse). */
+    int i1;   /**< Dernière ligne (exclue). */
+    int j0;   /**< Première colonne (incluse). */
+    int j1;   /**< Dernière colonne (exclue). */
+};
+
+/**
+ * @brief Nombre de paires i < j contenues dans une tuile.
+ */
+long long tilePairs(const Tile& t);
+
+/**
+ * @brief Découpe le triangle supérieur d'une matrice n × n en tuiles de côté T.
+ *
+ * Avec firstCol > 0, seules les paires i < j avec j >= firstCol sont découpées
+ * (mode ajout : les nouvelles séquences contre toutes les autres). Les lignes
+ * [0, firstCol) et [firstCol, n) sont alors découpées séparément, pour que les
+ * tuiles de la partie nouvelle restent alignées avec les colonnes.
+ *
+ * @param n        Nombre de séquences.
+ * @param T        Côté des tuiles (en nombre de séquences), T >= 1.
+ * @param firstCol Première colonne à calculer (0 = tout le triangle).
+ * @return Les tuiles (I, J) avec J >= I, dans l'ordre ligne par ligne.
+ */
+std::vector<Tile> upperTriangleTiles(int n, int T, int firstCol = 0);
+
+/**
+ * @brief Découpe le rectangle de paires [i0, i1) × [j0, j1) en tuiles de côté T.
+ *
+ * Utilisé par le mode anneau (--ring), où les lignes sont les séquences du
+ * rang et les colonnes celles du bloc reçu : il faut i1 <= j0 (aucune paire
+ * de la diagonale), toutes les paires du rectangle sont alors à calculer.
+ */
+std::vector<Tile> rectangleTiles(int i0, int i1, int j0, int j1, int T);
+
+/**
+ * @brief Tranche de tuiles [tBegin, tEnd) attribuée au rang rank.
+ *
+ * Les tranches sont contiguës et équilibrées en nombre de paires (et pas en
+ * nombre de tuiles, puisque les tuiles diagonales contiennent moitié moins
+ * de paires) : une tuile appartient au rang dont la part contient sa première paire.
+ */
+void tileRange(const std::vector<Tile>& tiles, int rank, int size,
+               std::size_t& tBegin, std::size_t& tEnd);
+
+/**
+ * @brief Côté de tuile par défaut, d'après la taille du cache L2 du processeur.
+ *
+ * On choisit T pour que 2T séquences (une tuile de lignes et une tuile de
+ * colonnes) occupent environ la moitié du L2, en gardant au moins 8 tuiles
+ * par rang pour que le découpage reste équilibré.
+ *
+ * @param bytesPerSeq Taille d'une séquence en mémoire (L en char, 8 * words en codé).
+ * @param n           Nombre de séquences (T ne dépasse pas n).
+ * @param size        Nombre de rangs qui se partagent les tuiles.
+ */
+int autoTileSize(std::size_t bytesPerSeq, int n, int size);
+
+/**
+ * @brief Applique f(i, j) à toutes les paires i < j d'une tuile,
+ *        ligne par ligne, j croissant.
+ */
+template <typename F>
+inline void forEachPair(const Tile& t, F&& f) {
+    for (int i = t.i0; i < t.i1; ++i) {
+        int jStart = (t.j0 > i + 1) ? t.j0 : i + 1;
+        for (int j = jStart; j < t.j1; ++j) {
+            f(i, j);
+        }
+    }
+}
+
+#endif // TILES_HPP
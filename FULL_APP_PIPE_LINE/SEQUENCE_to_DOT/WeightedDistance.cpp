@@ -0,0 +1,286 @@
+#define OMPI_SKIP_MPICXX 1
+#include "WeightedDistance.hpp"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define WEIGHTED_X86 1
+#endif
+
+// Coût d'une position d'après le XOR des deux codes.
+static inline int xorCost(const WeightedModel& m, int x) {
+    return x == 0 ? 0 : (x == 2 ? m.transition : m.transversion);
+}
+
+WeightedModel makeWeightedModel(int transition, int transversion,
+                                const std::vector<int>& positionWeights, int L)
+{
+    if (transition < 0 || transition > WEIGHTED_MAX_VALUE
+        || transversion < 0 || transversion > WEIGHTED_MAX_VALUE) {
+        throw std::runtime_error("Les couts de substitution doivent etre entre 0 et "
+                                 + std::to_string(WEIGHTED_MAX_VALUE));
+    }
+
+    WeightedModel m;
+    m.transition = transition;
+    m.transversion = transversion;
+    m.other = std::max(transition, transversion);
+    m.uniform = positionWeights.empty();
+
+    const int words = (L + 31) / 32;
+    m.weight.assign((size_t)words * 32, 0);
+    if (m.uniform) {
+        std::fill(m.weight.begin(), m.weight.begin() + L, (uint8_t)1);
+    } else {
+        if ((int)positionWeights.size() != L) {
+            throw std::runtime_error("Le fichier de poids donne " + std::to_string(positionWeights.size())
+                                     + " positions, les sequences en ont " + std::to_string(L));
+        }
+        for (int p = 0; p < L; ++p) {
+            if (positionWeights[p] < 0 || positionWeights[p] > WEIGHTED_MAX_VALUE) {
+                throw std::runtime_error("Poids invalide en position " + std::to_string(p)
+                                         + " (entre 0 et " + std::to_string(WEIGHTED_MAX_VALUE) + ")");
+            }
+            m.weight[p] = (uint8_t)positionWeights[p];
+        }
+    }
+
+    // Table des noyaux vectorisés : le code XOR d'une base arrive déplié sur
+    // un octet, tel quel (0..3) ou décalé de 2 bits (0, 4, 8, 12).
+    for (int x = 1; x < 4; ++x) {
+        m.lut[x] = (uint8_t)xorCost(m, x);
+        m.lut[x << 2] = (uint8_t)xorCost(m, x);
+    }
+
+    // FNV-1a sur les coûts et les poids
+    uint32_t h = 2166136261u;
+    auto mix = [&h](uint32_t v) {
+        h ^= v;
+        h *= 16777619u;
+    };
+    mix((uint32_t)transition);
+    mix((uint32_t)transversion);
+    for (int p = 0; p < L; ++p) mix(m.weight[p]);
+    m.fingerprint = h;
+
+    return m;
+}
+
+std::vector<int> readPositionWeights(const std::string& filename) {
+    std::ifstream in(filename);
+    if (!in) {
+        throw std::runtime_error("Impossible d'ouvrir le fichier de poids " + filename);
+    }
+
+    std::vector<int> weights;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (!line.empty() && line[0] == '#') continue;
+        std::istringstream iss(line);
+        int w;
+        while (iss >> w) weights.push_back(w);
+        if (!iss.eof()) {
+            throw std::runtime_error("Valeur non entiere dans le fichier de poids " + filename);
+        }
+    }
+    return weights;
+}
+
+// Corrige la somme calculée sur les codes aux positions des exceptions (comme
+// dans PackedSeqs.cpp) : on retire le coût compté avec le code 0 et on met
+// celui des vrais caractères. La correction est >= 0, car other est le plus
+// grand coût et deux exceptions (code 0 toutes les deux) n'ont rien coûté.
+static int exceptionCorrection(const WeightedModel& m, const PackedSeqs& ps,
+                               const uint64_t* a, const uint64_t* b, int i, int j)
+{
+    int pa = ps.excOffset[i], ea = ps.excOffset[i + 1];
+    int pb = ps.excOffset[j], eb = ps.excOffset[j + 1];
+
+    int corr = 0;
+    while (pa < ea || pb < eb) {
+        int p;
+        if (pb == eb || (pa < ea && ps.excPos[pa] < ps.excPos[pb])) {
+            p = ps.excPos[pa];
+        } else {
+            p = ps.excPos[pb];
+        }
+
+        int codeA = codeAt(a, p);
+        int codeB = codeAt(b, p);
+        char ca = (pa < ea && ps.excPos[pa] == p) ? ps.excChar[pa++] : (char)codeA;
+        char cb = (pb < eb && ps.excPos[pb] == p) ? ps.excChar[pb++] : (char)codeB;
+
+        corr += m.weight[p] * ((ca != cb ? m.other : 0) - xorCost(m, codeA ^ codeB));
+    }
+    return corr;
+}
+
+// Sans poids par position : le bit faible d'une paire du XOR marque une
+// transversion (XOR = 1 ou 3), le bit fort seul une transition (XOR = 2).
+static inline int weightedPopcountBody(const WeightedModel& m, const PackedSeqs& ps, int i, int j, int bound) {
+    const uint64_t* a = &ps.codes[(size_t)i * ps.words];
+    const uint64_t* b = &ps.codes[(size_t)j * ps.words];
+
+    int d = 0;
+    for (int w = 0; w < ps.words; ++w) {
+        uint64_t x = a[w] ^ b[w];
+        int tv = __builtin_popcountll(x & LOW_BITS);
+        int ts = __builtin_popcountll((x >> 1) & ~x & LOW_BITS);
+        d += m.transition * ts + m.transversion * tv;
+        // La correction des exceptions ne fait qu'augmenter d
+        if (d >= bound) return bound;
+    }
+
+    d += exceptionCorrection(m, ps, a, b, i, j);
+    return d < bound ? d : bound;
+}
+
+// Sans -mpopcnt, __builtin_popcountll est un appel de fonction : la même
+// boucle est aussi compilée avec l'instruction popcnt, prise si le processeur
+// l'a (tous ceux qui ont SSE4.2).
+static int weightedPopcount(const WeightedModel& m, const PackedSeqs& ps, int i, int j, int bound) {
+    return weightedPopcountBody(m, ps, i, j, bound);
+}
+
+#ifdef WEIGHTED_X86
+__attribute__((target("popcnt")))
+static int weightedPopcnt(const WeightedModel& m, const PackedSeqs& ps, int i, int j, int bound) {
+    return weightedPopcountBody(m, ps, i, j, bound);
+}
+#endif
+
+// Avec poids, version scalaire : une base à la fois dans les mots différents.
+static int weightedScalar(const WeightedModel& m, const PackedSeqs& ps, int i, int j, int bound) {
+    const uint64_t* a = &ps.codes[(size_t)i * ps.words];
+    const uint64_t* b = &ps.codes[(size_t)j * ps.words];
+
+    int d = 0;
+    for (int w = 0; w < ps.words; ++w) {
+        uint64_t x = a[w] ^ b[w];
+        const uint8_t* wt = &m.weight[(size_t)w * 32];
+        for (int t = 0; x != 0; ++t, x >>= 2) {
+            d += wt[t] * m.lut[x & 3];
+        }
+    }
+
+    d += exceptionCorrection(m, ps, a, b, i, j);
+    return d < bound ? d : bound;
+}
+
+#ifdef WEIGHTED_X86
+
+// Un mot XOR de 32 bases (8 octets, 4 bases par octet) est déplié en un octet
+// par base : pshufb recopie l'octet t / 4 dans la case t, puis on garde les
+// bits de la base t (masque 0x03 ou 0x0C sur l'octet, ou sur l'octet décalé
+// de 4 bits pour les bases 2 et 3). La valeur obtenue (0..3 ou 0, 4, 8, 12)
+// indexe la table des coûts avec un second pshufb, et pmaddubsw multiplie
+// les coûts par les poids (au plus 127 * 127 * 2, sans saturation).
+
+__attribute__((target("sse4.2")))
+static int weightedSSE42(const WeightedModel& m, const PackedSeqs& ps, int i, int j, int bound) {
+    const uint64_t* a = &ps.codes[(size_t)i * ps.words];
+    const uint64_t* b = &ps.codes[(size_t)j * ps.words];
+
+    const __m128i table  = _mm_loadu_si128((const __m128i*)m.lut);
+    const __m128i idxLo  = _mm_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3);
+    const __m128i idxHi  = _mm_setr_epi8(4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+    const __m128i mask01 = _mm_set1_epi32(0x00000C03);   // octets 03 0C 00 00
+    const __m128i mask23 = _mm_set1_epi32(0x0C030000);   // octets 00 00 03 0C
+    const __m128i ones   = _mm_set1_epi16(1);
+
+    __m128i acc = _mm_setzero_si128();
+    for (int w = 0; w < ps.words; ++w) {
+        uint64_t x = a[w] ^ b[w];
+        if (x == 0) continue;
+        __m128i v  = _mm_set1_epi64x((long long)x);
+        __m128i hi = _mm_srli_epi16(v, 4);
+        const __m128i idx[2] = {idxLo, idxHi};
+        for (int half = 0; half < 2; ++half) {
+            __m128i code = _mm_or_si128(_mm_and_si128(_mm_shuffle_epi8(v, idx[half]), mask01),
+                                        _mm_and_si128(_mm_shuffle_epi8(hi, idx[half]), mask23));
+            __m128i cost = _mm_shuffle_epi8(table, code);
+            __m128i wt = _mm_loadu_si128((const __m128i*)&m.weight[(size_t)w * 32 + 16 * half]);
+            acc = _mm_add_epi32(acc, _mm_madd_epi16(_mm_maddubs_epi16(cost, wt), ones));
+        }
+    }
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(1, 0, 3, 2)));
+    acc = _mm_add_epi32(acc, _mm_shuffle_epi32(acc, _MM_SHUFFLE(2, 3, 0, 1)));
+    int d = _mm_cvtsi128_si32(acc);
+
+    d += exceptionCorrection(m, ps, a, b, i, j);
+    return d < bound ? d : bound;
+}
+
+// AVX2 : les 32 bases d'un mot en un tour (pshufb reste dans chaque moitié
+// de 128 bits, mais le mot est recopié dans les deux).
+__attribute__((target("avx2")))
+static int weightedAVX2(const WeightedModel& m, const PackedSeqs& ps, int i, int j, int bound) {
+    const uint64_t* a = &ps.codes[(size_t)i * ps.words];
+    const uint64_t* b = &ps.codes[(size_t)j * ps.words];
+
+    const __m256i table  = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)m.lut));
+    const __m256i idx    = _mm256_setr_epi8(0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3,
+                                            4, 4, 4, 4, 5, 5, 5, 5, 6, 6, 6, 6, 7, 7, 7, 7);
+    const __m256i mask01 = _mm256_set1_epi32(0x00000C03);
+    const __m256i mask23 = _mm256_set1_epi32(0x0C030000);
+    const __m256i ones   = _mm256_set1_epi16(1);
+
+    __m256i acc = _mm256_setzero_si256();
+    for (int w = 0; w < ps.words; ++w) {
+        uint64_t x = a[w] ^ b[w];
+        if (x == 0) continue;
+        __m256i v  = _mm256_set1_epi64x((long long)x);
+        __m256i hi = _mm256_srli_epi16(v, 4);
+        __m256i code = _mm256_or_si256(_mm256_and_si256(_mm256_shuffle_epi8(v, idx), mask01),
+                                       _mm256_and_si256(_mm256_shuffle_epi8(hi, idx), mask23));
+        __m256i cost = _mm256_shuffle_epi8(table, code);
+        __m256i wt = _mm256_loadu_si256((const __m256i*)&m.weight[(size_t)w * 32]);
+        acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_maddubs_epi16(cost, wt), ones));
+    }
+    __m128i s = _mm_add_epi32(_mm256_castsi256_si128(acc), _mm256_extracti128_si256(acc, 1));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(1, 0, 3, 2)));
+    s = _mm_add_epi32(s, _mm_shuffle_epi32(s, _MM_SHUFFLE(2, 3, 0, 1)));
+    int d = _mm_cvtsi128_si32(s);
+
+    d += exceptionCorrection(m, ps, a, b, i, j);
+    return d < bound ? d : bound;
+}
+
+#endif // WEIGHTED_X86
+
+static WeightedKernel weightedKernelFor(SimdLevel level) {
+    switch (level) {
+#ifdef WEIGHTED_X86
+        case SimdLevel::SSE42:  return {weightedSSE42, "sse4.2"};
+        case SimdLevel::AVX2:
+        case SimdLevel::AVX512: return {weightedAVX2,  "avx2"};
+#endif
+        default:                return {weightedScalar, "scalar"};
+    }
+}
+
+WeightedKernel selectWeightedKernel(const WeightedModel& m, SimdLevel wanted) {
+    if (wanted != SimdLevel::Auto && !cpuSupportsSimd(wanted)) {
+        throw std::runtime_error(std::string("Jeu d'instructions non supporte par ce processeur : ")
+                                 + (wanted == SimdLevel::AVX512 ? "avx512bw" : weightedKernelFor(wanted).name));
+    }
+    if (m.uniform) {
+#ifdef WEIGHTED_X86
+        if (wanted != SimdLevel::Scalar && cpuSupportsSimd(SimdLevel::SSE42)) {
+            return {weightedPopcnt, "popcnt"};
+        }
+#endif
+        return {weightedPopcount, "popcount"};
+    }
+    if (wanted == SimdLevel::Auto) {
+        const SimdLevel order[] = {SimdLevel::AVX2, SimdLevel::SSE42};
+        for (SimdLevel level : order) {
+            if (cpuSupportsSimd(level)) return weightedKernelFor(level);
+        }
+        return weightedKernelFor(SimdLevel::Scalar);
+    }
+    return weightedKernelFor(wanted);
+}
@@ -0,0 +1,91 @@
+#ifndef WEIGHTED_DISTANCE_HPP
+#define WEIGHTED_DISTANCE_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "HammingKernels.hpp"
+#include "PackedSeqs.hpp"
+
+/**
+ * @file WeightedDistance.hpp
+ * @brief Distance pondérée (--distance=weighted) : coût par type de substitution
+ *        et poids par position, calculée sur les séquences codées sur 2 bits.
+ *
+ * d(a, b) = somme sur les positions p de poids[p] * coût(a[p], b[p]), avec
+ * coût = 0 pour deux bases égales, "transition" pour A <-> G et C <-> T/U
+ * (purine <-> purine, pyrimidine <-> pyrimidine), et "transversion" pour les
+ * autres substitutions. Une différence qui touche une base hors alphabet
+ * (N, ...) coûte le plus grand des deux.
+ *
+ * Avec le codage de PackedSeqs (A = 0, C = 1, G = 2, T/U = 3), le coût ne
+ * dépend que du XOR des deux codes : 0 = égalité, 2 = transition, 1 ou 3 =
+ * transversion. Sans poids par position, il suffit donc de deux popcount par
+ * mot de 32 bases. Avec des poids, chaque code XOR est déplié sur un octet
+ * (pshufb), son coût est lu dans une table de 16 octets (pshufb encore), puis
+ * multiplié par le poids de la position (pmaddubsw) : 32 bases par tour en AVX2.
+ */
+
+/** Plus grande valeur acceptée pour un coût ou un poids (produits sur 16 bits). */
+const int WEIGHTED_MAX_VALUE = 127;
+
+/**
+ * @struct WeightedModel
+ * @brief Coûts des substitutions et poids des positions.
+ */
+struct WeightedModel {
+    int transition = 1;            /**< Coût A <-> G, C <-> T/U. */
+    int transversion = 2;          /**< Coût des autres substitutions. */
+    int other = 2;                 /**< Coût d'une différence avec une base hors alphabet. */
+    bool uniform = true;           /**< Tous les poids valent 1 (pas de fichier de poids). */
+    std::vector<uint8_t> weight;   /**< Poids de chaque position, complété par des 0 jusqu'à un multiple de 32. */
+    uint8_t lut[16] = {};          /**< Coût d'après le code XOR déplié (voir WeightedDistance.cpp). */
+    uint32_t fingerprint = 0;      /**< Empreinte des coûts et des poids (fichiers d'arêtes). */
+};
+
+/**
+ * @brief Prépare le modèle de distance pour des séquences de longueur L.
+ *
+ * @param positionWeights Poids de chaque position (taille L), ou vide pour 1 partout.
+ * @throw std::runtime_error si un coût ou un poids sort de [0, WEIGHTED_MAX_VALUE],
+ *        ou si le nombre de poids n'est pas L.
+ */
+WeightedModel makeWeightedModel(int transition, int transversion,
+                                const std::vector<int>& positionWeights, int L);
+
+/**
+ * @brief Lit un fichier de poids par position (des entiers séparés par des
+ *        blancs ; les lignes qui commencent par '#' sont ignorées).
+ *
+ * @throw std::runtime_error si le fichier est absent ou contient autre chose que des entiers.
+ */
+std::vector<int> readPositionWeights(const std::string& filename);
+
+/**
+ * @brief Signature des noyaux : distance pondérée entre les séquences i et j,
+ *        saturée à bound (min(d, bound)).
+ */
+typedef int (*WeightedFn)(const WeightedModel& m, const PackedSeqs& ps, int i, int j, int bound);
+
+/**
+ * @struct WeightedKernel
+ * @brief Noyau retenu et son nom.
+ */
+struct WeightedKernel {
+    WeightedFn fn;       /**< Fonction à appeler. */
+    const char* name;    /**< "popcnt" / "popcount" sans poids, sinon jeu d'instructions ("scalar", "sse4.2", "avx2"). */
+};
+
+/**
+ * @brief Choisit le noyau d'après le modèle et le processeur.
+ *
+ * Sans poids par position, le noyau popcount est toujours pris (avec
+ * l'instruction popcnt si le processeur l'a, sauf avec Scalar). Sinon, comme
+ * pour le noyau char : Auto prend le plus large supporté (AVX-512 utilise le
+ * noyau AVX2).
+ *
+ * @throw std::runtime_error si le jeu demandé n'est pas supporté par ce processeur.
+ */
+WeightedKernel selectWeightedKernel(const WeightedModel& m, SimdLevel wanted);
+
+#endif // WEIGHTED_DISTANCE_HPP
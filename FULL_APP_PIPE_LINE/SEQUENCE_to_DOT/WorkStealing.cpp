@@ -0,0 +1,50 @@
+#include "WorkStealing.hpp"
+
+WorkStealingRanges::WorkStealingRanges(std::size_t begin, std::size_t end, int nWorkers) {
+    const std::size_t total = end - begin;
+    for (int w = 0; w < nWorkers; ++w) {
+        ranges_.push_back(std::unique_ptr<Range>(new Range));
+        ranges_[w]->lo = begin + total * w / nWorkers;
+        ranges_[w]->hi = begin + total * (w + 1) / nWorkers;
+    }
+}
+
+bool WorkStealingRanges::next(int worker, std::size_t& task) {
+    Range& mine = *ranges_[worker];
+    while (true) {
+        {
+            std::lock_guard<std::mutex> lock(mine.m);
+            if (mine.lo < mine.hi) {
+                task = mine.lo++;
+                return true;
+            }
+        }
+        // Ma part est vide : je vole, et s'il n'y a plus rien nulle part c'est fini
+        if (!steal(worker)) return false;
+    }
+}
+
+bool WorkStealingRanges::steal(int worker) {
+    const int n = (int)ranges_.size();
+    // Je commence par mon voisin pour que les threads ne visent pas tous la même part
+    for (int k = 1; k < n; ++k) {
+        Range& victim = *ranges_[(worker + k) % n];
+        std::size_t lo, hi;
+        {
+            std::lock_guard<std::mutex> lock(victim.m);
+            if (victim.lo >= victim.hi) continue;
+            // Je prends la moitié arrière (au moins une tâche) ;
+            // le propriétaire continue de consommer l'avant.
+            std::size_t mid = victim.lo + (victim.hi - victim.lo) / 2;
+            lo = mid;
+            hi = victim.hi;
+            victim.hi = mid;
+        }
+        Range& mine = *ranges_[worker];
+        std::lock_guard<std::mutex> lock(mine.m);
+        mine.lo = lo;
+        mine.hi = hi;
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,84 @@
+#ifndef WORK_STEALING_HPP
+#define WORK_STEALING_HPP
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @file WorkStealing.hpp
+ * @brief Répartition de tâches (des indices de tuiles) entre threads, avec vol de travail.
+ *
+ * Chaque thread reçoit au départ une part contiguë des tâches et la consomme
+ * par le début. Quand sa part est vide, il va voler la moitié arrière de la
+ * part d'un autre thread. Les tuiles n'ont pas toutes le même coût (tuiles
+ * diagonales, distance bornée, ...) : le vol absorbe ce déséquilibre sans
+ * file centrale partagée par tout le monde.
+ *
+ * Les tâches sont grosses (une tuile = des milliers de paires), donc un simple
+ * verrou par part suffit.
+ */
+
+/**
+ * @class WorkStealingRanges
+ * @brief Parts de tâches [lo, hi) de chaque thread, avec vol de la moitié arrière.
+ */
+class WorkStealingRanges {
+public:
+    /**
+     * @brief Découpe [begin, end) en nWorkers parts contiguës de même taille.
+     */
+    WorkStealingRanges(std::size_t begin, std::size_t end, int nWorkers);
+
+    /**
+     * @brief Donne la prochaine tâche du thread worker.
+     *
+     * @param worker Numéro du thread (0 .. nWorkers - 1).
+     * @param task   Tâche obtenue.
+     * @return false quand il n'y a plus rien à faire nulle part.
+     */
+    bool next(int worker, std::size_t& task);
+
+private:
+    struct Range {
+        std::mutex m;
+        std::size_t lo = 0;
+        std::size_t hi = 0;
+    };
+    std::vector<std::unique_ptr<Range>> ranges_;
+
+    bool steal(int worker);
+};
+
+/**
+ * @brief Exécute body(worker, t) pour toutes les tâches t de [begin, end)
+ *        avec nThreads threads (le thread appelant est le thread 0).
+ *
+ * Avec nThreads <= 1, la boucle est simplement faite dans l'ordre, sans thread.
+ * body ne doit appeler MPI que pour worker == 0 (seul le thread principal
+ * communique).
+ */
+template <typename F>
+void parallelForStealing(std::size_t begin, std::size_t end, int nThreads, F&& body) {
+    if (nThreads <= 1) {
+        for (std::size_t t = begin; t < end; ++t) body(0, t);
+        return;
+    }
+
+    WorkStealingRanges queues(begin, end, nThreads);
+    auto work = [&](int w) {
+        std::size_t t;
+        while (queues.next(w, t)) body(w, t);
+    };
+
+    std::vector<std::thread> pool;
+    for (int w = 1; w < nThreads; ++w) {
+        pool.emplace_back(work, w);
+    }
+    work(0);
+    for (std::thread& th : pool) th.join();
+}
+
+#endif // WORK_STEALING_HPP